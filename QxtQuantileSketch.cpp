@@ -0,0 +1,300 @@
+#include "QxtQuantileSketch.h"
+#include <QtAlgorithms>
+#include <QPair>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+// 相邻层容量的比例
+const double CapacityDecay = 2.0 / 3.0;
+
+// 最底层的最小容量
+const int MinimumCapacity = 8;
+} // namespace
+
+/*!
+    \class QxtQuantileSketch
+    \inmodule QxtWidgets
+    \brief QxtQuantileSketch 是可合并的 KLL 流式分位数草图。
+
+    草图由若干层压缩器组成，第 h 层中的每个数值代表 2^h 个原始数值。插入的数值进入第 0 层；
+    保存的数值总数超过各层容量之和时，最低的满层被排序，每对相邻数值中随机保留一个并提升到上一层。
+    最上层的容量为 k，往下每层乘以 2/3，因此保存的数值个数不超过约 3k，与插入的数量无关。
+
+    quantile() 和 rank() 在按数值排序的加权视图上查询，视图只在草图变化后的第一次查询时重建。
+    merge() 逐层拼接两个草图再压缩，可以用来合并各个线程各自维护的草图。
+
+    \sa QxtSpanSlider::setQuantileSketch()
+ */
+
+/*!
+    构造一个精度参数为 \a k 的空草图。
+ */
+QxtQuantileSketch::QxtQuantileSketch(int k) :
+        kk(qMax(k, MinimumCapacity)),
+        n(0),
+        minValue(0),
+        maxValue(0),
+        random(0x9e3779b9u),
+        retained(0),
+        levels(1),
+        sortedValid(false)
+{
+}
+
+/*!
+    返回精度参数 k。
+ */
+int QxtQuantileSketch::k() const
+{
+    return kk;
+}
+
+/*!
+    插入数值 \a value。NaN 被忽略。
+ */
+void QxtQuantileSketch::insert(double value)
+{
+    if (qIsNaN(value))
+        return;
+
+    if (n == 0)
+    {
+        minValue = value;
+        maxValue = value;
+    }
+    else
+    {
+        minValue = qMin(minValue, value);
+        maxValue = qMax(maxValue, value);
+    }
+    ++n;
+    levels[0].append(value);
+    ++retained;
+    sortedValid = false;
+
+    if (retained >= totalCapacity())
+        compress();
+}
+
+/*!
+    \overload
+    依次插入 \a values 中的 \a size 个数值。
+ */
+void QxtQuantileSketch::insert(const double* values, qint64 size)
+{
+    for (qint64 i = 0; i < size; ++i)
+        insert(values[i]);
+}
+
+/*!
+    把 \a other 合并到此草图中。两个草图的精度参数可以不同，结果使用此草图的 k。
+ */
+void QxtQuantileSketch::merge(const QxtQuantileSketch& other)
+{
+    if (other.n == 0)
+        return;
+
+    if (n == 0)
+    {
+        minValue = other.minValue;
+        maxValue = other.maxValue;
+    }
+    else
+    {
+        minValue = qMin(minValue, other.minValue);
+        maxValue = qMax(maxValue, other.maxValue);
+    }
+    n += other.n;
+
+    while (levels.size() < other.levels.size())
+        levels.append(QVector<double>());
+    for (int h = 0; h < other.levels.size(); ++h)
+        levels[h] += other.levels.at(h);
+    retained += other.retained;
+    sortedValid = false;
+
+    compress();
+}
+
+/*!
+    清空草图。
+ */
+void QxtQuantileSketch::clear()
+{
+    n = 0;
+    minValue = 0;
+    maxValue = 0;
+    retained = 0;
+    levels = QVector<QVector<double> >(1);
+    sortedValid = false;
+    sortedValues.clear();
+    cumulativeWeights.clear();
+}
+
+/*!
+    如果草图中没有数值，则返回 true。
+ */
+bool QxtQuantileSketch::isEmpty() const
+{
+    return n == 0;
+}
+
+/*!
+    返回插入的数值个数。
+ */
+qint64 QxtQuantileSketch::count() const
+{
+    return n;
+}
+
+/*!
+    返回插入的最小值。草图为空时返回 0。
+ */
+double QxtQuantileSketch::minimum() const
+{
+    return minValue;
+}
+
+/*!
+    返回插入的最大值。草图为空时返回 0。
+ */
+double QxtQuantileSketch::maximum() const
+{
+    return maxValue;
+}
+
+/*!
+    返回第 \a q 分位数的估计值，\a q 被限制在 0 到 1 之间。0 和 1 分别返回精确的最小值和最大值，
+    草图为空时返回 0。
+ */
+double QxtQuantileSketch::quantile(qreal q) const
+{
+    if (n == 0)
+        return 0;
+    if (q <= 0)
+        return minValue;
+    if (q >= 1)
+        return maxValue;
+
+    ensureSorted();
+    const qint64 total = cumulativeWeights.last();
+    const qint64 target = qint64(std::ceil(q * total));
+    const QVector<qint64>::const_iterator it = std::lower_bound(cumulativeWeights.constBegin(), cumulativeWeights.constEnd(), target);
+    const int index = qMin(int(it - cumulativeWeights.constBegin()), sortedValues.size() - 1);
+    return sortedValues.at(index);
+}
+
+/*!
+    返回小于等于 \a value 的数值所占比例的估计值。草图为空时返回 0。
+ */
+qreal QxtQuantileSketch::rank(double value) const
+{
+    if (n == 0)
+        return 0;
+    if (value < minValue)
+        return 0;
+    if (value >= maxValue)
+        return 1;
+
+    ensureSorted();
+    const QVector<double>::const_iterator it = std::upper_bound(sortedValues.constBegin(), sortedValues.constEnd(), value);
+    const int index = int(it - sortedValues.constBegin());
+    if (index == 0)
+        return 0;
+    return qreal(cumulativeWeights.at(index - 1)) / cumulativeWeights.last();
+}
+
+/*!
+    返回草图当前保存的数值个数，它不超过约 3k，与 count() 无关。
+ */
+int QxtQuantileSketch::retainedCount() const
+{
+    return retained;
+}
+
+int QxtQuantileSketch::capacity(int level) const
+{
+    // 最上层容量为 k，往下每层乘以 2/3
+    const int depth = levels.size() - 1 - level;
+    return qMax(MinimumCapacity, int(std::ceil(kk * std::pow(CapacityDecay, depth))));
+}
+
+int QxtQuantileSketch::totalCapacity() const
+{
+    int total = 0;
+    for (int h = 0; h < levels.size(); ++h)
+        total += capacity(h);
+    return total;
+}
+
+void QxtQuantileSketch::compress()
+{
+    // 保存的数值总数超出总容量时，压缩最低的一个满层
+    while (retained >= totalCapacity())
+    {
+        int h = 0;
+        while (h + 1 < levels.size() && levels.at(h).size() < capacity(h))
+            ++h;
+        compact(h);
+    }
+}
+
+void QxtQuantileSketch::compact(int h)
+{
+    if (h + 1 == levels.size())
+        levels.append(QVector<double>());
+
+    QVector<double>& level = levels[h];
+    std::sort(level.begin(), level.end());
+
+    // 数量为奇数时把最后一个数值留在本层
+    const int pairs = level.size() / 2;
+    const double leftover = level.last();
+    const bool odd = (level.size() % 2) != 0;
+
+    // xorshift 随机选择保留每对中的第一个还是第二个
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+    const int offset = int(random & 1);
+
+    QVector<double>& above = levels[h + 1];
+    for (int i = 0; i < pairs; ++i)
+        above.append(level.at(2 * i + offset));
+
+    level.clear();
+    if (odd)
+        level.append(leftover);
+    retained -= pairs;
+    sortedValid = false;
+}
+
+void QxtQuantileSketch::ensureSorted() const
+{
+    if (sortedValid)
+        return;
+
+    QVector<QPair<double, qint64> > items;
+    items.reserve(retained);
+    for (int h = 0; h < levels.size(); ++h)
+    {
+        const qint64 weight = qint64(1) << h;
+        const QVector<double>& level = levels.at(h);
+        for (int i = 0; i < level.size(); ++i)
+            items.append(qMakePair(level.at(i), weight));
+    }
+    std::sort(items.begin(), items.end());
+
+    sortedValues.resize(items.size());
+    cumulativeWeights.resize(items.size());
+    qint64 sum = 0;
+    for (int i = 0; i < items.size(); ++i)
+    {
+        sum += items.at(i).second;
+        sortedValues[i] = items.at(i).first;
+        cumulativeWeights[i] = sum;
+    }
+    sortedValid = true;
+}
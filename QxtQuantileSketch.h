@@ -0,0 +1,70 @@
+#ifndef QXTQUANTILESKETCH_H
+#define QXTQUANTILESKETCH_H
+
+#include <QtGlobal>
+#include <QVector>
+
+// QxtQuantileSketch 是 KLL 流式分位数草图：逐个或成批插入数值，占用的内存只与精度参数 k 有关，
+// 与插入的数量无关。不同线程中的草图可以合并，合并结果与把所有数据插入同一个草图的精度相同。
+// 草图本身不是线程安全的，每个线程应使用自己的草图，最后再合并。
+class QxtQuantileSketch {
+public:
+    // 构造函数，k 越大精度越高，秩误差约为 1.7 / k
+    explicit QxtQuantileSketch(int k = 200);
+
+    // 获取精度参数
+    int k() const;
+
+    // 插入数值，NaN 被忽略
+    void insert(double value);
+    void insert(const double* values, qint64 size);
+
+    // 合并另一个草图
+    void merge(const QxtQuantileSketch& other);
+
+    // 清空草图
+    void clear();
+
+    // 获取插入的数量、最小值和最大值
+    bool isEmpty() const;
+    qint64 count() const;
+    double minimum() const;
+    double maximum() const;
+
+    // 返回第 q（0 到 1）分位数，以及小于等于 value 的数值所占的比例
+    double quantile(qreal q) const;
+    qreal rank(double value) const;
+
+    // 当前保存的数值个数
+    int retainedCount() const;
+
+private:
+    // 第 level 层压缩器的容量
+    int capacity(int level) const;
+
+    // 各层容量之和
+    int totalCapacity() const;
+
+    // 保存的数值超出总容量时压缩最低的满层
+    void compress();
+
+    // 压缩第 h 层：排序后把一半的数值以加倍的权重提升到上一层
+    void compact(int h);
+
+    // 按数值排序的加权视图，查询时按需重建
+    void ensureSorted() const;
+
+    int kk;
+    qint64 n;
+    double minValue;
+    double maxValue;
+    quint32 random;
+    int retained;
+    QVector<QVector<double> > levels;
+
+    mutable bool sortedValid;
+    mutable QVector<double> sortedValues;
+    mutable QVector<qint64> cumulativeWeights;
+};
+
+#endif // QXTQUANTILESKETCH_H
@@ -0,0 +1,654 @@
+#include "QxtQuickSpanSlider.h"
+#include "QxtSpanSliderLogic_p.h"
+#include <QQuickWindow>
+#include <QSGRectangleNode>
+#include <QSGNode>
+#include <QMatrix4x4>
+#include <QKeyEvent>
+#include <QMouseEvent>
+
+namespace
+{
+// 滑块的场景图：静态的滑槽节点，以及只通过变换移动的跨度和两个滑块柄节点
+class SpanSliderNode : public QSGNode
+{
+public:
+    QSGRectangleNode* groove;
+    QSGTransformNode* spanTransform;
+    QSGRectangleNode* span;
+    QSGTransformNode* lowerTransform;
+    QSGRectangleNode* lowerHandle;
+    QSGTransformNode* upperTransform;
+    QSGRectangleNode* upperHandle;
+};
+
+// 滑槽和跨度的厚度
+const qreal TrackThickness = 4;
+
+// 只在矩阵变化时更新变换节点，避免把未移动的节点标记为脏
+void setMatrix(QSGTransformNode* node, const QMatrix4x4& matrix)
+{
+    if (node->matrix() != matrix)
+        node->setMatrix(matrix);
+}
+} // namespace
+
+/*!
+    \class QxtQuickSpanSlider
+    \inmodule QxtWidgets
+    \brief QxtQuickSpanSlider 是 QxtSpanSlider 的 Qt Quick 版本。
+
+    QxtQuickSpanSlider 与 QxtSpanSlider 共用 QxtSpanSliderLogic 中的移动规则：键盘动作的目标滑块柄和目标值、
+    HandleMovementMode 的限制、自由移动时越过另一个滑块柄后的控制交换，以及两个滑块柄重合时按第一次移动的方向选择滑块柄。
+    拖动两个滑块柄之间的跨度会保持宽度平移整个跨度。
+
+    场景图以保留模式构建：滑槽是一个只在尺寸、方向或颜色变化时更新的矩形节点；跨度是一个单位长度的矩形，
+    由变换节点平移和缩放；两个滑块柄各自挂在一个变换节点下。拖动一个滑块柄时只有它和跨度的两个变换矩阵发生变化，
+    不会重建几何数据，也不会触发 QML 绑定的重新计算。所有节点都由 QQuickWindow::createRectangleNode() 创建，
+    因此同样适用于软件渲染的场景图后端。
+
+    \code
+    qmlRegisterType<QxtQuickSpanSlider>("Qxt", 1, 0, "SpanSlider");
+    \endcode
+ */
+
+/*!
+    使用 \a parent 构造一个新的 QxtQuickSpanSlider。范围为 0 到 99，跨度覆盖整个范围。
+ */
+QxtQuickSpanSlider::QxtQuickSpanSlider(QQuickItem* parent) :
+        QQuickItem(parent),
+        rangeMin(0),
+        rangeMax(99),
+        lower(0),
+        upper(99),
+        step(1),
+        orient(Qt::Horizontal),
+        movement(QxtSpanSlider::FreeMovement),
+        mainControl(QxtSpanSlider::LowerHandle),
+        pressedHandle(QxtSpanSlider::NoHandle),
+        spanPressed(false),
+        firstMovement(false),
+        pressOffset(0),
+        spanPressValue(0),
+        spanPressLower(0),
+        handleLength(12),
+        grooveCol(0xc8, 0xc8, 0xc8),
+        spanCol(0x30, 0x8c, 0xc6),
+        handleCol(0x60, 0x60, 0x60),
+        grooveDirty(true)
+{
+    setFlag(ItemHasContents, true);
+    setAcceptedMouseButtons(Qt::LeftButton);
+    setActiveFocusOnTab(true);
+    setImplicitSize(160, 22);
+}
+
+/*!
+    销毁 QxtQuickSpanSlider 对象。
+ */
+QxtQuickSpanSlider::~QxtQuickSpanSlider()
+{
+}
+
+/*!
+    \property QxtQuickSpanSlider::minimum
+    \brief 范围的最小值
+ */
+int QxtQuickSpanSlider::minimum() const
+{
+    return rangeMin;
+}
+
+void QxtQuickSpanSlider::setMinimum(int minimum)
+{
+    setRange(minimum, qMax(minimum, rangeMax));
+}
+
+/*!
+    \property QxtQuickSpanSlider::maximum
+    \brief 范围的最大值
+ */
+int QxtQuickSpanSlider::maximum() const
+{
+    return rangeMax;
+}
+
+void QxtQuickSpanSlider::setMaximum(int maximum)
+{
+    setRange(qMin(rangeMin, maximum), maximum);
+}
+
+/*!
+    把范围设置为 [\a minimum, \a maximum]，跨度被限制在新的范围之内。与 QAbstractSlider 相同，
+    \a maximum 小于 \a minimum 时取 \a minimum。
+ */
+void QxtQuickSpanSlider::setRange(int minimum, int maximum)
+{
+    maximum = qMax(minimum, maximum);
+    if (minimum == rangeMin && maximum == rangeMax)
+        return;
+
+    rangeMin = minimum;
+    rangeMax = maximum;
+    emit rangeChanged(rangeMin, rangeMax);
+    setSpan(lower, upper);
+    update();
+}
+
+/*!
+    \property QxtQuickSpanSlider::lowerValue
+    \brief 范围的下限值
+ */
+int QxtQuickSpanSlider::lowerValue() const
+{
+    return lower;
+}
+
+void QxtQuickSpanSlider::setLowerValue(int lower)
+{
+    setSpan(lower, upper);
+}
+
+/*!
+    \property QxtQuickSpanSlider::upperValue
+    \brief 范围的上限值
+ */
+int QxtQuickSpanSlider::upperValue() const
+{
+    return upper;
+}
+
+void QxtQuickSpanSlider::setUpperValue(int upper)
+{
+    setSpan(lower, upper);
+}
+
+/*!
+    设置范围，从 \a lower 到 \a upper。两个值被限制在范围之内，并按大小排序。
+ */
+void QxtQuickSpanSlider::setSpan(int lower, int upper)
+{
+    const int low = qBound(rangeMin, qMin(lower, upper), rangeMax);
+    const int upp = qBound(rangeMin, qMax(lower, upper), rangeMax);
+    if (low != this->lower || upp != this->upper)
+    {
+        if (low != this->lower)
+        {
+            this->lower = low;
+            emit lowerValueChanged(low);
+        }
+        if (upp != this->upper)
+        {
+            this->upper = upp;
+            emit upperValueChanged(upp);
+        }
+        emit spanChanged(this->lower, this->upper);
+        update();
+    }
+}
+
+/*!
+    保持跨度宽度不变，把跨度平移到以 \a lower 为下限的位置，跨度被限制在范围之内。
+
+    \sa QxtSpanSlider::moveSpan()
+ */
+void QxtQuickSpanSlider::moveSpan(int lower)
+{
+    const qint64 width = qint64(upper) - this->lower;
+    const int newLower = int(qBound(qint64(rangeMin), qint64(lower), qint64(rangeMax) - width));
+    setSpan(newLower, int(newLower + width));
+}
+
+/*!
+    \property QxtQuickSpanSlider::singleStep
+    \brief 方向键移动滑块柄的步长，默认值为 1
+ */
+int QxtQuickSpanSlider::singleStep() const
+{
+    return step;
+}
+
+void QxtQuickSpanSlider::setSingleStep(int step)
+{
+    this->step = step;
+}
+
+/*!
+    \property QxtQuickSpanSlider::orientation
+    \brief 滑块的方向，默认为水平。垂直方向时最小值在下方
+ */
+Qt::Orientation QxtQuickSpanSlider::orientation() const
+{
+    return orient;
+}
+
+void QxtQuickSpanSlider::setOrientation(Qt::Orientation orientation)
+{
+    if (orient != orientation)
+    {
+        orient = orientation;
+        invalidateGroove();
+        emit orientationChanged();
+    }
+}
+
+/*!
+    \property QxtQuickSpanSlider::handleMovementMode
+    \brief 滑块移动模式，与 QxtSpanSlider::handleMovementMode 相同
+ */
+QxtQuickSpanSlider::HandleMovementMode QxtQuickSpanSlider::handleMovementMode() const
+{
+    return HandleMovementMode(movement);
+}
+
+void QxtQuickSpanSlider::setHandleMovementMode(HandleMovementMode mode)
+{
+    movement = QxtSpanSlider::HandleMovementMode(mode);
+}
+
+/*!
+    \property QxtQuickSpanSlider::pressed
+    \brief 是否正在拖动滑块柄或跨度
+ */
+bool QxtQuickSpanSlider::isPressed() const
+{
+    return pressedHandle != QxtSpanSlider::NoHandle || spanPressed;
+}
+
+/*!
+    \property QxtQuickSpanSlider::handleSize
+    \brief 滑块柄沿滑槽方向的长度，默认值为 12
+ */
+qreal QxtQuickSpanSlider::handleSize() const
+{
+    return handleLength;
+}
+
+void QxtQuickSpanSlider::setHandleSize(qreal size)
+{
+    if (handleLength != size)
+    {
+        handleLength = qMax<qreal>(size, 1);
+        invalidateGroove();
+        emit appearanceChanged();
+    }
+}
+
+/*!
+    \property QxtQuickSpanSlider::grooveColor
+    \brief 滑槽的颜色
+ */
+QColor QxtQuickSpanSlider::grooveColor() const
+{
+    return grooveCol;
+}
+
+void QxtQuickSpanSlider::setGrooveColor(const QColor& color)
+{
+    if (grooveCol != color)
+    {
+        grooveCol = color;
+        invalidateGroove();
+        emit appearanceChanged();
+    }
+}
+
+/*!
+    \property QxtQuickSpanSlider::spanColor
+    \brief 跨度的颜色
+ */
+QColor QxtQuickSpanSlider::spanColor() const
+{
+    return spanCol;
+}
+
+void QxtQuickSpanSlider::setSpanColor(const QColor& color)
+{
+    if (spanCol != color)
+    {
+        spanCol = color;
+        invalidateGroove();
+        emit appearanceChanged();
+    }
+}
+
+/*!
+    \property QxtQuickSpanSlider::handleColor
+    \brief 滑块柄的颜色
+ */
+QColor QxtQuickSpanSlider::handleColor() const
+{
+    return handleCol;
+}
+
+void QxtQuickSpanSlider::setHandleColor(const QColor& color)
+{
+    if (handleCol != color)
+    {
+        handleCol = color;
+        invalidateGroove();
+        emit appearanceChanged();
+    }
+}
+
+/*!
+    \reimp
+    与 QxtSpanSlider::keyPressEvent() 相同：方向键单步移动，Home 和 End 把滑块柄移到最小值和最大值。
+ */
+void QxtQuickSpanSlider::keyPressEvent(QKeyEvent* event)
+{
+    bool main = true;
+    QAbstractSlider::SliderAction action = QAbstractSlider::SliderNoAction;
+    switch (event->key())
+    {
+    case Qt::Key_Left:
+        main   = (orient == Qt::Horizontal);
+        action = QAbstractSlider::SliderSingleStepSub;
+        break;
+    case Qt::Key_Right:
+        main   = (orient == Qt::Horizontal);
+        action = QAbstractSlider::SliderSingleStepAdd;
+        break;
+    case Qt::Key_Up:
+        main   = (orient == Qt::Vertical);
+        action = QAbstractSlider::SliderSingleStepAdd;
+        break;
+    case Qt::Key_Down:
+        main   = (orient == Qt::Vertical);
+        action = QAbstractSlider::SliderSingleStepSub;
+        break;
+    case Qt::Key_Home:
+        main   = (mainControl == QxtSpanSlider::LowerHandle);
+        action = QAbstractSlider::SliderToMinimum;
+        break;
+    case Qt::Key_End:
+        main   = (mainControl == QxtSpanSlider::UpperHandle);
+        action = QAbstractSlider::SliderToMaximum;
+        break;
+    default:
+        event->ignore();
+        return;
+    }
+
+    triggerAction(action, main);
+    event->accept();
+}
+
+/*!
+    \reimp
+    按下滑块柄时开始拖动该滑块柄，按下两个滑块柄之间的跨度时开始拖动整个跨度。
+ */
+void QxtQuickSpanSlider::mousePressEvent(QMouseEvent* event)
+{
+    if (rangeMin == rangeMax)
+    {
+        event->ignore();
+        return;
+    }
+
+    const qreal pos = pick(event->localPos());
+    const qreal lowerPos = valueToPixel(lower);
+    const qreal upperPos = valueToPixel(upper);
+    if (qAbs(pos - upperPos) <= handleLength / 2)
+    {
+        pressedHandle = QxtSpanSlider::UpperHandle;
+        pressOffset = pos - upperPos;
+    }
+    else if (qAbs(pos - lowerPos) <= handleLength / 2)
+    {
+        pressedHandle = QxtSpanSlider::LowerHandle;
+        pressOffset = pos - lowerPos;
+    }
+    else if (pos > qMin(lowerPos, upperPos) && pos < qMax(lowerPos, upperPos))
+    {
+        spanPressed = true;
+        spanPressValue = pixelToValue(pos);
+        spanPressLower = lower;
+    }
+    else
+    {
+        event->ignore();
+        return;
+    }
+
+    firstMovement = true;
+    forceActiveFocus(Qt::MouseFocusReason);
+    emit pressedChanged();
+    event->accept();
+}
+
+/*!
+    \reimp
+ */
+void QxtQuickSpanSlider::mouseMoveEvent(QMouseEvent* event)
+{
+    const qreal pos = pick(event->localPos());
+    if (spanPressed)
+    {
+        const qint64 delta = qint64(pixelToValue(pos)) - spanPressValue;
+        moveSpan(int(qBound(qint64(rangeMin), spanPressLower + delta, qint64(rangeMax))));
+        event->accept();
+        return;
+    }
+    if (pressedHandle == QxtSpanSlider::NoHandle)
+    {
+        event->ignore();
+        return;
+    }
+
+    const int value = pixelToValue(pos - pressOffset);
+
+    // 在第一次移动时，选择优先操作的滑块
+    if (firstMovement)
+    {
+        if (lower == upper)
+        {
+            if (value < lower)
+            {
+                pressedHandle = QxtSpanSlider::LowerHandle;
+                mainControl = QxtSpanSliderLogic::otherHandle(mainControl);
+                firstMovement = false;
+            }
+        }
+        else
+        {
+            firstMovement = false;
+        }
+    }
+
+    moveHandle(pressedHandle == QxtSpanSlider::UpperHandle, value);
+    event->accept();
+}
+
+/*!
+    \reimp
+ */
+void QxtQuickSpanSlider::mouseReleaseEvent(QMouseEvent* event)
+{
+    mouseUngrabEvent();
+    event->accept();
+}
+
+/*!
+    \reimp
+ */
+void QxtQuickSpanSlider::mouseUngrabEvent()
+{
+    if (isPressed())
+    {
+        pressedHandle = QxtSpanSlider::NoHandle;
+        spanPressed = false;
+        emit pressedChanged();
+    }
+}
+
+/*!
+    \reimp
+    第一次调用时创建所有节点；之后只在尺寸、方向或颜色变化时更新滑槽和矩形，
+    其余情况下只更新跨度和两个滑块柄的变换矩阵。
+ */
+QSGNode* QxtQuickSpanSlider::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data)
+{
+    Q_UNUSED(data);
+    SpanSliderNode* root = static_cast<SpanSliderNode*>(oldNode);
+    if (!root)
+    {
+        root = new SpanSliderNode;
+        root->groove = window()->createRectangleNode();
+        root->appendChildNode(root->groove);
+
+        root->spanTransform = new QSGTransformNode;
+        root->span = window()->createRectangleNode();
+        root->spanTransform->appendChildNode(root->span);
+        root->appendChildNode(root->spanTransform);
+
+        root->lowerTransform = new QSGTransformNode;
+        root->lowerHandle = window()->createRectangleNode();
+        root->lowerTransform->appendChildNode(root->lowerHandle);
+        root->appendChildNode(root->lowerTransform);
+
+        root->upperTransform = new QSGTransformNode;
+        root->upperHandle = window()->createRectangleNode();
+        root->upperTransform->appendChildNode(root->upperHandle);
+        root->appendChildNode(root->upperTransform);
+        grooveDirty = true;
+    }
+
+    const bool horizontal = (orient == Qt::Horizontal);
+    const qreal w = width();
+    const qreal h = height();
+    if (grooveDirty)
+    {
+        // 跨度是单位长度的矩形，实际的位置和长度由变换给出；滑块柄以原点为中心
+        if (horizontal)
+        {
+            root->groove->setRect(QRectF(0, (h - TrackThickness) / 2, w, TrackThickness));
+            root->span->setRect(QRectF(0, (h - TrackThickness) / 2, 1, TrackThickness));
+            root->lowerHandle->setRect(QRectF(-handleLength / 2, 0, handleLength, h));
+            root->upperHandle->setRect(QRectF(-handleLength / 2, 0, handleLength, h));
+        }
+        else
+        {
+            root->groove->setRect(QRectF((w - TrackThickness) / 2, 0, TrackThickness, h));
+            root->span->setRect(QRectF((w - TrackThickness) / 2, 0, TrackThickness, 1));
+            root->lowerHandle->setRect(QRectF(0, -handleLength / 2, w, handleLength));
+            root->upperHandle->setRect(QRectF(0, -handleLength / 2, w, handleLength));
+        }
+        root->groove->setColor(grooveCol);
+        root->span->setColor(spanCol);
+        root->lowerHandle->setColor(handleCol);
+        root->upperHandle->setColor(handleCol);
+        grooveDirty = false;
+    }
+
+    // 拖动时只有这里的变换会改变
+    const qreal lowerPos = valueToPixel(lower);
+    const qreal upperPos = valueToPixel(upper);
+    const qreal start = qMin(lowerPos, upperPos);
+    const qreal length = qAbs(upperPos - lowerPos);
+    QMatrix4x4 spanMatrix;
+    QMatrix4x4 lowerMatrix;
+    QMatrix4x4 upperMatrix;
+    if (horizontal)
+    {
+        spanMatrix.translate(start, 0);
+        spanMatrix.scale(length, 1);
+        lowerMatrix.translate(lowerPos, 0);
+        upperMatrix.translate(upperPos, 0);
+    }
+    else
+    {
+        spanMatrix.translate(0, start);
+        spanMatrix.scale(1, length);
+        lowerMatrix.translate(0, lowerPos);
+        upperMatrix.translate(0, upperPos);
+    }
+    setMatrix(root->spanTransform, spanMatrix);
+    setMatrix(root->lowerTransform, lowerMatrix);
+    setMatrix(root->upperTransform, upperMatrix);
+    return root;
+}
+
+/*!
+    \reimp
+ */
+void QxtQuickSpanSlider::geometryChanged(const QRectF& newGeometry, const QRectF& oldGeometry)
+{
+    QQuickItem::geometryChanged(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size())
+        invalidateGroove();
+}
+
+void QxtQuickSpanSlider::triggerAction(QAbstractSlider::SliderAction action, bool main)
+{
+    const bool up = QxtSpanSliderLogic::targetsUpper(main, mainControl);
+    int value = 0;
+    if (QxtSpanSliderLogic::actionValue(action, up ? upper : lower, step, rangeMin, rangeMax, &value))
+        moveHandle(up, value);
+}
+
+void QxtQuickSpanSlider::moveHandle(bool upperHandle, int value)
+{
+    const QxtSpanSliderLogic::Move move = QxtSpanSliderLogic::moveHandle(movement, upperHandle, value, lower, upper);
+    int newLower = lower;
+    int newUpper = upper;
+    if (move.swap)
+    {
+        // 越过另一个滑块柄：两个滑块柄交换角色，另一个滑块柄的值成为新跨度的另一端
+        mainControl = QxtSpanSliderLogic::otherHandle(mainControl);
+        if (pressedHandle != QxtSpanSlider::NoHandle)
+            pressedHandle = QxtSpanSliderLogic::otherHandle(pressedHandle);
+        if (upperHandle)
+        {
+            newUpper = lower;
+            newLower = move.value;
+        }
+        else
+        {
+            newLower = upper;
+            newUpper = move.value;
+        }
+    }
+    else if (upperHandle)
+    {
+        newUpper = move.value;
+    }
+    else
+    {
+        newLower = move.value;
+    }
+    setSpan(newLower, newUpper);
+}
+
+qreal QxtQuickSpanSlider::valueToPixel(int value) const
+{
+    const qreal length = qMax<qreal>((orient == Qt::Horizontal ? width() : height()) - handleLength, 0);
+    qreal fraction = 0;
+    if (rangeMax > rangeMin)
+        fraction = (qreal(value) - rangeMin) / (qreal(rangeMax) - rangeMin);
+    if (orient == Qt::Vertical)
+        fraction = 1 - fraction;
+    return handleLength / 2 + fraction * length;
+}
+
+int QxtQuickSpanSlider::pixelToValue(qreal pos) const
+{
+    const qreal length = (orient == Qt::Horizontal ? width() : height()) - handleLength;
+    if (length <= 0)
+        return rangeMin;
+    qreal fraction = qBound<qreal>(0, (pos - handleLength / 2) / length, 1);
+    if (orient == Qt::Vertical)
+        fraction = 1 - fraction;
+    return int(rangeMin + qRound64(fraction * (qreal(rangeMax) - rangeMin)));
+}
+
+qreal QxtQuickSpanSlider::pick(const QPointF& pt) const
+{
+    return orient == Qt::Horizontal ? pt.x() : pt.y();
+}
+
+void QxtQuickSpanSlider::invalidateGroove()
+{
+    grooveDirty = true;
+    update();
+}
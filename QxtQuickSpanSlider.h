@@ -0,0 +1,139 @@
+#ifndef QXTQUICKSPANSLIDER_H
+#define QXTQUICKSPANSLIDER_H
+
+#include <QQuickItem>
+#include <QColor>
+#include "QxtSpanSlider.h"
+
+// QxtQuickSpanSlider 是 QxtSpanSlider 的 Qt Quick 版本，与其共用滑块柄的移动规则。
+// 它以保留模式构建场景图：滑槽节点只在尺寸或颜色变化时更新，拖动时只改变滑块柄和跨度的变换
+class QxtQuickSpanSlider : public QQuickItem {
+    Q_OBJECT
+
+    // 属性声明，用于集成 Qt 的属性系统
+    Q_PROPERTY(int minimum READ minimum WRITE setMinimum NOTIFY rangeChanged)
+    Q_PROPERTY(int maximum READ maximum WRITE setMaximum NOTIFY rangeChanged)
+    Q_PROPERTY(int lowerValue READ lowerValue WRITE setLowerValue NOTIFY lowerValueChanged)
+    Q_PROPERTY(int upperValue READ upperValue WRITE setUpperValue NOTIFY upperValueChanged)
+    Q_PROPERTY(int singleStep READ singleStep WRITE setSingleStep)
+    Q_PROPERTY(Qt::Orientation orientation READ orientation WRITE setOrientation NOTIFY orientationChanged)
+    Q_PROPERTY(HandleMovementMode handleMovementMode READ handleMovementMode WRITE setHandleMovementMode)
+    Q_PROPERTY(bool pressed READ isPressed NOTIFY pressedChanged)
+    Q_PROPERTY(qreal handleSize READ handleSize WRITE setHandleSize NOTIFY appearanceChanged)
+    Q_PROPERTY(QColor grooveColor READ grooveColor WRITE setGrooveColor NOTIFY appearanceChanged)
+    Q_PROPERTY(QColor spanColor READ spanColor WRITE setSpanColor NOTIFY appearanceChanged)
+    Q_PROPERTY(QColor handleColor READ handleColor WRITE setHandleColor NOTIFY appearanceChanged)
+    Q_ENUMS(HandleMovementMode) // 声明 HandleMovementMode 枚举类型
+
+public:
+    // 构造函数
+    explicit QxtQuickSpanSlider(QQuickItem* parent = 0);
+    virtual ~QxtQuickSpanSlider(); // 析构函数
+
+    // 枚举：定义滑块柄移动模式，取值与 QxtSpanSlider::HandleMovementMode 相同
+    enum HandleMovementMode {
+        FreeMovement = QxtSpanSlider::FreeMovement,
+        NoCrossing = QxtSpanSlider::NoCrossing,
+        NoOverlapping = QxtSpanSlider::NoOverlapping
+    };
+
+    // 获取和设置范围
+    int minimum() const;
+    void setMinimum(int minimum);
+    int maximum() const;
+    void setMaximum(int maximum);
+    Q_INVOKABLE void setRange(int minimum, int maximum);
+
+    // 获取下限和上限值
+    int lowerValue() const;
+    int upperValue() const;
+
+    // 获取和设置步长、方向和移动模式
+    int singleStep() const;
+    void setSingleStep(int step);
+    Qt::Orientation orientation() const;
+    void setOrientation(Qt::Orientation orientation);
+    HandleMovementMode handleMovementMode() const;
+    void setHandleMovementMode(HandleMovementMode mode);
+
+    // 是否正在拖动
+    bool isPressed() const;
+
+    // 外观
+    qreal handleSize() const;
+    void setHandleSize(qreal size);
+    QColor grooveColor() const;
+    void setGrooveColor(const QColor& color);
+    QColor spanColor() const;
+    void setSpanColor(const QColor& color);
+    QColor handleColor() const;
+    void setHandleColor(const QColor& color);
+
+public Q_SLOTS:
+    // 设置值的槽函数
+    void setLowerValue(int lower);
+    void setUpperValue(int upper);
+    void setSpan(int lower, int upper);
+    void moveSpan(int lower);
+
+Q_SIGNALS:
+    // 范围和值变化的信号
+    void spanChanged(int lower, int upper);
+    void lowerValueChanged(int lower);
+    void upperValueChanged(int upper);
+    void rangeChanged(int minimum, int maximum);
+
+    // 方向、按下状态和外观变化的信号
+    void orientationChanged();
+    void pressedChanged();
+    void appearanceChanged();
+
+protected:
+    // 事件处理函数：键盘和鼠标事件
+    virtual void keyPressEvent(QKeyEvent* event);
+    virtual void mousePressEvent(QMouseEvent* event);
+    virtual void mouseMoveEvent(QMouseEvent* event);
+    virtual void mouseReleaseEvent(QMouseEvent* event);
+    virtual void mouseUngrabEvent();
+
+    // 场景图
+    virtual QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data);
+    virtual void geometryChanged(const QRectF& newGeometry, const QRectF& oldGeometry);
+
+private:
+    // 与 QxtSpanSlider 相同语义的滑块动作
+    void triggerAction(QAbstractSlider::SliderAction action, bool main);
+
+    // 按移动模式把下限或上限滑块柄移到 value，必要时交换控制
+    void moveHandle(bool upperHandle, int value);
+
+    // 像素位置与范围值之间的换算
+    qreal valueToPixel(int value) const;
+    int pixelToValue(qreal pos) const;
+    qreal pick(const QPointF& pt) const;
+
+    // 标记滑槽需要重建并请求更新
+    void invalidateGroove();
+
+    int rangeMin;
+    int rangeMax;
+    int lower;
+    int upper;
+    int step;
+    Qt::Orientation orient;
+    QxtSpanSlider::HandleMovementMode movement;
+    QxtSpanSlider::SpanHandle mainControl;
+    QxtSpanSlider::SpanHandle pressedHandle;
+    bool spanPressed;
+    bool firstMovement;
+    qreal pressOffset;
+    int spanPressValue;
+    int spanPressLower;
+    qreal handleLength;
+    QColor grooveCol;
+    QColor spanCol;
+    QColor handleCol;
+    bool grooveDirty;
+};
+
+#endif // QXTQUICKSPANSLIDER_H
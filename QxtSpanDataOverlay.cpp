@@ -0,0 +1,153 @@
+#include "QxtSpanDataOverlay.h"
+#include "QxtSpanDataSource.h"
+#include "QxtSpanSlider.h"
+#include <QImage>
+#include <QPainter>
+#include <QMutexLocker>
+#include <cmath>
+#include <limits>
+
+/*!
+    \class QxtSpanDataOverlay
+    \inmodule QxtWidgets
+    \brief QxtSpanDataOverlay 把 QxtSpanDataSource 的数据分布绘制为 QxtSpanSlider 的叠加层。
+
+    每一遍渲染对图像主轴上的每个像素调用一次 QxtSpanDataSource::histogram()，以像素数为区间数，
+    密度条的长度按计数的对数缩放到当前视图中的最大计数。使用 QxtSpanColumnSource 时，
+    渲染耗时只与像素宽度有关，与列的大小无关。
+
+    数据源由调用者拥有，必须比叠加层存活得更久。setDataSource() 和 setColor() 会自动调用 invalidate()；
+    QxtSpanDataSource 没有变化通知，数据源的内容变化后调用者必须自行调用 invalidate()。
+
+    渲染在工作线程中调用数据源，并且可能在 setDataSource() 返回之后仍在使用旧的数据源，
+    因此数据源的内容变化本身必须对并发的查询是安全的。QxtSpanColumnSource 满足这一点：
+    叠加层使用它时可以直接调用 open() 重新打开列文件，期间的渲染得到空的分布，完成后调用 invalidate()。
+    其他数据源如果不能在查询进行时修改数据，应在修改前调用 QxtSpanSlider::setOverlay(0) 等待渲染结束，
+    修改后再重新设置叠加层。
+ */
+
+/*!
+    使用数据源 \a source 和 \a parent 构造一个新的 QxtSpanDataOverlay。
+ */
+QxtSpanDataOverlay::QxtSpanDataOverlay(const QxtSpanDataSource* source, QObject* parent) :
+        QxtSpanSliderOverlay(parent),
+        source(source),
+        barColor(0, 0, 0, 64)
+{
+}
+
+/*!
+    销毁 QxtSpanDataOverlay 对象。
+ */
+QxtSpanDataOverlay::~QxtSpanDataOverlay()
+{
+}
+
+/*!
+    返回数据源。
+ */
+const QxtSpanDataSource* QxtSpanDataOverlay::dataSource() const
+{
+    QMutexLocker locker(&mutex);
+    return source;
+}
+
+/*!
+    把数据源设置为 \a source，并使已有的渲染结果失效。
+ */
+void QxtSpanDataOverlay::setDataSource(const QxtSpanDataSource* source)
+{
+    {
+        QMutexLocker locker(&mutex);
+        this->source = source;
+    }
+    invalidate();
+}
+
+/*!
+    返回密度条的颜色。默认为半透明的黑色。
+ */
+QColor QxtSpanDataOverlay::color() const
+{
+    QMutexLocker locker(&mutex);
+    return barColor;
+}
+
+/*!
+    把密度条的颜色设置为 \a color，并使已有的渲染结果失效。
+ */
+void QxtSpanDataOverlay::setColor(const QColor& color)
+{
+    {
+        QMutexLocker locker(&mutex);
+        barColor = color;
+    }
+    invalidate();
+}
+
+/*!
+    把 \a slider 的范围设置为数据源的最小值和最大值，超出 int 的部分被截断。
+
+    范围和跨度在同一个批量更新事务中提交：跨度被限制在新的范围之内，
+    原来覆盖整个范围的跨度仍然覆盖整个新范围。数据源不可用或为空时不做任何事。
+ */
+void QxtSpanDataOverlay::autoscale(QxtSpanSlider* slider) const
+{
+    const QxtSpanDataSource* data = dataSource();
+    if (!slider || !data || !data->isValid() || data->count() == 0)
+        return;
+
+    const int minimum = int(qBound(qint64(std::numeric_limits<int>::min()), data->minimum(), qint64(std::numeric_limits<int>::max())));
+    const int maximum = int(qBound(qint64(std::numeric_limits<int>::min()), data->maximum(), qint64(std::numeric_limits<int>::max())));
+    const bool full = (slider->lowerValue() == slider->minimum() && slider->upperValue() == slider->maximum());
+
+    QxtSpanSliderUpdateGuard guard(slider);
+    slider->setRange(minimum, maximum);
+    if (full)
+        slider->setSpan(minimum, maximum);
+}
+
+/*!
+    \reimp
+ */
+void QxtSpanDataOverlay::render(QImage* image, const QxtSpanSliderOverlayRequest& request) const
+{
+    const QxtSpanDataSource* data = 0;
+    QColor color;
+    {
+        QMutexLocker locker(&mutex);
+        data = source;
+        color = barColor;
+    }
+    if (!data || !data->isValid() || request.maximum <= request.minimum)
+        return;
+
+    const bool horizontal = (request.orientation == Qt::Horizontal);
+    const int length = horizontal ? image->width() : image->height();
+    const int thickness = horizontal ? image->height() : image->width();
+    const QVector<qreal> counts = data->histogram(request.minimum, request.maximum, length);
+    if (request.isCanceled())
+        return;
+
+    qreal peak = 0;
+    for (int i = 0; i < counts.size(); ++i)
+        peak = qMax(peak, counts.at(i));
+    if (peak <= 0)
+        return;
+
+    // 按对数缩放，稀疏区域的少量数据也能看见
+    const qreal scale = thickness / std::log1p(peak);
+    QPainter painter(image);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(color);
+    for (int i = 0; i < counts.size(); ++i)
+    {
+        if (counts.at(i) <= 0)
+            continue;
+        const int bar = qMax(1, qRound(std::log1p(counts.at(i)) * scale));
+        if (horizontal)
+            painter.drawRect(i, thickness - bar, 1, bar);
+        else
+            painter.drawRect(0, i, bar, 1);
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef QXTSPANDATAOVERLAY_H
+#define QXTSPANDATAOVERLAY_H
+
+#include "QxtSpanSliderOverlay.h"
+#include <QColor>
+#include <QMutex>
+
+// 前向声明
+class QxtSpanDataSource;
+class QxtSpanSlider;
+
+// QxtSpanDataOverlay 把 QxtSpanDataSource 的数据分布绘制为滑槽后方的密度条，
+// 并可以按数据的最小值和最大值自动设置滑块的范围
+class QxtSpanDataOverlay : public QxtSpanSliderOverlay {
+    Q_OBJECT
+public:
+    // 构造函数
+    explicit QxtSpanDataOverlay(const QxtSpanDataSource* source, QObject* parent = 0);
+    virtual ~QxtSpanDataOverlay(); // 析构函数
+
+    // 获取和设置数据源
+    const QxtSpanDataSource* dataSource() const;
+    void setDataSource(const QxtSpanDataSource* source);
+
+    // 获取和设置密度条的颜色
+    QColor color() const;
+    void setColor(const QColor& color);
+
+    // 把滑块的范围设置为数据的最小值和最大值
+    void autoscale(QxtSpanSlider* slider) const;
+
+    // QxtSpanSliderOverlay 接口
+    virtual void render(QImage* image, const QxtSpanSliderOverlayRequest& request) const;
+
+private:
+    mutable QMutex mutex;
+    const QxtSpanDataSource* source;
+    QColor barColor;
+};
+
+#endif // QXTSPANDATAOVERLAY_H
@@ -0,0 +1,587 @@
+#include "QxtSpanDataSource.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QMetaObject>
+#include <QPointer>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QSaveFile>
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+// 旁路文件的标识和格式版本
+const quint32 PyramidMagic = 0x51585350; // "QXSP"
+// 版本 2 起桶按字段经 QDataStream 以大端字节序写出，与主机的字节序和结构布局无关
+const quint32 PyramidVersion = 2;
+
+// 把浮点数向下取整并限制在 qint64 的范围内
+qint64 floorToKey(double value)
+{
+    const double limit = 9.2e18;
+    return qint64(qBound(-limit, std::floor(value), limit));
+}
+
+// 尝试获取读锁，获取不到时不阻塞
+class TryReadLocker {
+public:
+    explicit TryReadLocker(QReadWriteLock* lock) : lock(lock), locked(lock->tryLockForRead()) {}
+    ~TryReadLocker()
+    {
+        if (locked)
+            lock->unlock();
+    }
+
+    bool isLocked() const { return locked; }
+
+private:
+    Q_DISABLE_COPY(TryReadLocker)
+
+    QReadWriteLock* lock;
+    bool locked;
+};
+
+// 在工作线程中打开数据源，并把结果通知接收者
+class OpenTask : public QRunnable {
+public:
+    OpenTask(QxtSpanColumnSource* source, QObject* receiver, const char* member) :
+            source(source),
+            receiver(receiver),
+            member(member)
+    {
+    }
+
+    virtual void run()
+    {
+        const bool ok = source->open();
+        if (receiver && !member.isEmpty())
+            QMetaObject::invokeMethod(receiver.data(), member.constData(), Qt::QueuedConnection, Q_ARG(bool, ok));
+    }
+
+private:
+    QxtSpanColumnSource* source;
+    QPointer<QObject> receiver;
+    QByteArray member;
+};
+} // namespace
+
+/*!
+    \class QxtSpanDataSource
+    \inmodule QxtWidgets
+    \brief QxtSpanDataSource 是滑块范围轴上数据分布的抽象接口。
+
+    实现只需要回答元素数量、数据的最小值和最大值，以及给定区间内的分桶计数。
+    QxtSpanDataOverlay 用它绘制数据密度并自动缩放滑块的范围。
+    叠加层在工作线程中调用这些 const 函数，实现必须保证它们是线程安全的。
+ */
+
+/*!
+    销毁数据源。
+ */
+QxtSpanDataSource::~QxtSpanDataSource()
+{
+}
+
+/*!
+    \fn QxtSpanDataSource::histogram(qint64 from, qint64 to, int bins) const
+    把 [\a from, \a to] 等分为 \a bins 个区间，返回每个区间内的元素数量。
+    数量可以是估计值，因此使用浮点数表示。
+ */
+
+/*!
+    \class QxtSpanColumnSource
+    \inmodule QxtWidgets
+    \brief QxtSpanColumnSource 以内存映射方式读取二进制数值列，并用预先计算的金字塔回答分布查询。
+
+    列文件是连续存放的定长元素，使用本机字节序，元素类型由 ElementType 指定。open() 用 QFile::map() 映射列文件，
+    然后加载与列文件同名、后缀为 \c .pyr 的旁路文件。旁路文件不存在、格式不符，或者记录的列文件大小和修改时间
+    与当前文件不一致时，对映射的数据扫描两遍重新构建金字塔并保存，整个过程不会把列读入内存。
+    旁路文件的所有字段（包括每个桶）都经 QDataStream 以大端字节序逐个写出，与主机的字节序和结构布局无关。
+
+    金字塔的最底层把 [minimum(), maximum()] 等分为 leafCount 个桶，每个桶记录元素数量以及桶内元素的实际最小值和最大值；
+    上面每一层由下一层相邻的两个桶合并而成。histogram() 选择桶宽不超过区间宽度的最粗一层，
+    每个区间只访问常数个桶，因此耗时与区间数（通常是像素宽度）成正比。跨越区间边界的桶按其实际的最小值和最大值
+    所覆盖的比例分配计数；区间比最底层的桶更窄时，结果是按比例估计的近似值。
+
+    浮点列中的 NaN 被忽略，其余值向下取整。所有 const 函数都是线程安全的。
+
+    映射和金字塔由一个读写锁保护。open() 和 close() 持有写锁，const 函数只尝试获取读锁：
+    重新打开的过程中，其他线程（例如叠加层的渲染线程）中的查询不会访问正在释放或重建的数据，
+    而是立即返回不可用的结果，isValid() 为 false，histogram() 全为 0。
+    因此可以在叠加层仍在使用数据源时重新打开列文件，完成后调用 QxtSpanSliderOverlay::invalidate() 重新渲染。
+ */
+
+/*!
+    构造一个读取 \a fileName、元素类型为 \a type 的数据源。最底层的桶数 \a leafCount 向上取整为 2 的幂，
+    并且不会超过数据的取值个数。调用 open() 之后数据源才可用。
+ */
+QxtSpanColumnSource::QxtSpanColumnSource(const QString& fileName, ElementType type, int leafCount) :
+        file(fileName),
+        type(type),
+        requestedLeaves(qBound(1, leafCount, 1 << 24)),
+        data(0),
+        rows(0),
+        lastModified(0),
+        dataMin(0),
+        dataMax(0),
+        leaves(0)
+{
+}
+
+/*!
+    关闭映射并销毁数据源。
+ */
+QxtSpanColumnSource::~QxtSpanColumnSource()
+{
+    close();
+}
+
+/*!
+    映射列文件并加载或构建金字塔。成功时返回 true，失败时返回 false，errorString() 给出原因。
+
+    旁路文件保存失败（例如目录不可写）不会导致打开失败，只是下次打开时需要重新构建。
+
+    open() 是同步的：旁路文件可用时只需读取金字塔，否则要扫描映射的整个列两遍，对大文件可能需要数秒。
+    在 GUI 线程中请使用 openAsync()。
+
+    \sa openAsync()
+ */
+bool QxtSpanColumnSource::open()
+{
+    QWriteLocker locker(&lock);
+    reset();
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        error = file.errorString();
+        return false;
+    }
+
+    const qint64 size = file.size();
+    if (size % elementSize() != 0)
+    {
+        error = QString::fromLatin1("File size is not a multiple of the element size");
+        reset();
+        return false;
+    }
+
+    rows = size / elementSize();
+    if (rows > 0)
+    {
+        data = file.map(0, size);
+        if (!data)
+        {
+            error = file.errorString();
+            reset();
+            return false;
+        }
+    }
+    lastModified = QFileInfo(file).lastModified().toMSecsSinceEpoch();
+
+    if (!loadPyramid())
+    {
+        buildPyramid();
+        savePyramid();
+    }
+    error.clear();
+    return true;
+}
+
+/*!
+    在线程池 \a pool（为 0 时使用 QThreadPool::globalInstance()）中调用 open()，立即返回。
+
+    完成后，如果 \a receiver 和 \a member 都不为 0，则以排队连接调用 \a receiver 的槽函数 \a member，
+    参数为 open() 的返回值。\a member 是不带参数列表的函数名，该函数必须是槽函数或者用 Q_INVOKABLE 声明。
+    打开期间其他线程中的查询立即返回不可用的结果，接收者通常在槽函数中调用叠加层的 invalidate()：
+    \code
+    source->openAsync(this, "columnOpened");
+
+    void Viewer::columnOpened(bool ok)
+    {
+        if (ok)
+        {
+            overlay->autoscale(slider);
+            overlay->invalidate();
+        }
+    }
+    \endcode
+
+    数据源在打开完成之前不能被销毁。
+ */
+void QxtSpanColumnSource::openAsync(QObject* receiver, const char* member, QThreadPool* pool)
+{
+    if (!pool)
+        pool = QThreadPool::globalInstance();
+    pool->start(new OpenTask(this, receiver, member));
+}
+
+/*!
+    取消映射并释放金字塔。会等待其他线程中正在进行的查询结束。
+ */
+void QxtSpanColumnSource::close()
+{
+    QWriteLocker locker(&lock);
+    reset();
+}
+
+void QxtSpanColumnSource::reset()
+{
+    if (data)
+        file.unmap(data);
+    file.close();
+    data = 0;
+    rows = 0;
+    lastModified = 0;
+    dataMin = 0;
+    dataMax = 0;
+    leaves = 0;
+    buckets.clear();
+    levelOffsets.clear();
+}
+
+/*!
+    返回最近一次 open() 失败的原因。
+ */
+QString QxtSpanColumnSource::errorString() const
+{
+    const TryReadLocker locker(&lock);
+    return locker.isLocked() ? error : QString();
+}
+
+/*!
+    返回列文件的路径。
+ */
+QString QxtSpanColumnSource::fileName() const
+{
+    return file.fileName();
+}
+
+/*!
+    返回保存金字塔的旁路文件的路径，即列文件的路径加上 \c .pyr 后缀。
+ */
+QString QxtSpanColumnSource::pyramidFileName() const
+{
+    return file.fileName() + QLatin1String(".pyr");
+}
+
+/*!
+    返回金字塔的层数。
+ */
+int QxtSpanColumnSource::levelCount() const
+{
+    const TryReadLocker locker(&lock);
+    return locker.isLocked() ? levelOffsets.size() : 0;
+}
+
+/*!
+    通过内存映射读取第 \a row 个元素。浮点数向下取整，NaN 返回 0。
+ */
+qint64 QxtSpanColumnSource::value(qint64 row) const
+{
+    const TryReadLocker locker(&lock);
+    qint64 v = 0;
+    if (locker.isLocked() && row >= 0 && row < rows && element(row, &v))
+        return v;
+    return 0;
+}
+
+/*!
+    \reimp
+ */
+bool QxtSpanColumnSource::isValid() const
+{
+    const TryReadLocker locker(&lock);
+    return locker.isLocked() && !levelOffsets.isEmpty();
+}
+
+/*!
+    \reimp
+    返回列中元素的数量，包括浮点列中被忽略的 NaN。
+ */
+qint64 QxtSpanColumnSource::count() const
+{
+    const TryReadLocker locker(&lock);
+    return locker.isLocked() ? rows : 0;
+}
+
+/*!
+    \reimp
+ */
+qint64 QxtSpanColumnSource::minimum() const
+{
+    const TryReadLocker locker(&lock);
+    return locker.isLocked() ? dataMin : 0;
+}
+
+/*!
+    \reimp
+ */
+qint64 QxtSpanColumnSource::maximum() const
+{
+    const TryReadLocker locker(&lock);
+    return locker.isLocked() ? dataMax : 0;
+}
+
+/*!
+    \reimp
+ */
+QVector<qreal> QxtSpanColumnSource::histogram(qint64 from, qint64 to, int bins) const
+{
+    QVector<qreal> result(qMax(bins, 0), 0);
+    const TryReadLocker locker(&lock);
+    if (!locker.isLocked() || levelOffsets.isEmpty() || bins <= 0 || to < from || buckets.at(levelOffsets.last()).count == 0)
+        return result;
+
+    // 选择桶宽不超过区间宽度的最粗一层，每个区间最多访问常数个桶
+    const double binWidth = (double(to) - double(from) + 1) / bins;
+    const double leafWidth = (double(dataMax) - double(dataMin) + 1) / leaves;
+    int index = 0;
+    while (index + 1 < levelOffsets.size() && leafWidth * double(1 << (index + 1)) <= binWidth)
+        ++index;
+
+    const Bucket* bucket = level(index);
+    const int size = levelSize(index);
+    const double width = leafWidth * double(1 << index);
+    for (int i = 0; i < bins; ++i)
+    {
+        const double begin = double(from) + i * binWidth;
+        const double end = begin + binWidth;
+        if (end <= double(dataMin) || begin > double(dataMax))
+            continue;
+
+        const int first = int(qBound(0.0, std::floor((begin - double(dataMin)) / width), double(size - 1)));
+        const int last = int(qBound(0.0, std::floor((end - double(dataMin)) / width), double(size - 1)));
+        qreal sum = 0;
+        for (int k = first; k <= last; ++k)
+        {
+            const Bucket& b = bucket[k];
+            if (b.count == 0)
+                continue;
+
+            // 按桶内元素实际覆盖的区间与当前区间的重叠比例分配计数
+            const double lo = qMax(double(b.min), begin);
+            const double hi = qMin(double(b.max) + 1, end);
+            if (hi > lo)
+                sum += b.count * (hi - lo) / (double(b.max) - double(b.min) + 1);
+        }
+        result[i] = sum;
+    }
+    return result;
+}
+
+int QxtSpanColumnSource::elementSize() const
+{
+    switch (type)
+    {
+    case Int32:
+    case Float:
+        return 4;
+    case Int64:
+    case Double:
+    default:
+        return 8;
+    }
+}
+
+bool QxtSpanColumnSource::element(qint64 index, qint64* value) const
+{
+    const uchar* p = data + index * elementSize();
+    switch (type)
+    {
+    case Int32:
+    {
+        qint32 v;
+        memcpy(&v, p, sizeof(v));
+        *value = v;
+        return true;
+    }
+    case Int64:
+        memcpy(value, p, sizeof(*value));
+        return true;
+    case Float:
+    {
+        float v;
+        memcpy(&v, p, sizeof(v));
+        if (qIsNaN(v))
+            return false;
+        *value = floorToKey(v);
+        return true;
+    }
+    case Double:
+    default:
+    {
+        double v;
+        memcpy(&v, p, sizeof(v));
+        if (qIsNaN(v))
+            return false;
+        *value = floorToKey(v);
+        return true;
+    }
+    }
+}
+
+bool QxtSpanColumnSource::loadPyramid()
+{
+    QFile in(pyramidFileName());
+    if (!in.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&in);
+    stream.setVersion(QDataStream::Qt_5_0);
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint32 storedType = 0;
+    qint64 storedSize = 0;
+    qint64 storedModified = 0;
+    qint64 storedRows = 0;
+    qint32 storedRequest = 0;
+    qint64 storedMin = 0;
+    qint64 storedMax = 0;
+    qint32 storedLeaves = 0;
+    stream >> magic >> version >> storedType >> storedSize >> storedModified >> storedRows
+           >> storedRequest >> storedMin >> storedMax >> storedLeaves;
+
+    // 旁路文件必须与当前的列文件和参数完全对应，否则视为过时
+    if (stream.status() != QDataStream::Ok || magic != PyramidMagic || version != PyramidVersion
+        || storedType != qint32(type) || storedSize != file.size() || storedModified != lastModified
+        || storedRows != rows || storedRequest != requestedLeaves || storedLeaves <= 0
+        || storedLeaves > requestedLeaves * 2 || (storedLeaves & (storedLeaves - 1)) != 0)
+        return false;
+
+    dataMin = storedMin;
+    dataMax = storedMax;
+    leaves = storedLeaves;
+    layoutLevels();
+    for (int i = 0; i < buckets.size(); ++i)
+    {
+        Bucket& b = buckets[i];
+        stream >> b.count >> b.min >> b.max;
+    }
+    if (stream.status() != QDataStream::Ok || !stream.atEnd())
+    {
+        leaves = 0;
+        buckets.clear();
+        levelOffsets.clear();
+        return false;
+    }
+    return true;
+}
+
+void QxtSpanColumnSource::buildPyramid()
+{
+    // 第一遍：求数据的最小值和最大值
+    bool any = false;
+    dataMin = 0;
+    dataMax = 0;
+    for (qint64 i = 0; i < rows; ++i)
+    {
+        qint64 v;
+        if (!element(i, &v))
+            continue;
+        if (!any)
+        {
+            dataMin = dataMax = v;
+            any = true;
+        }
+        else
+        {
+            dataMin = qMin(dataMin, v);
+            dataMax = qMax(dataMax, v);
+        }
+    }
+
+    // 桶数取 2 的幂，且不多于取值的个数
+    const double span = double(dataMax) - double(dataMin) + 1;
+    leaves = 1;
+    while (leaves < requestedLeaves)
+        leaves *= 2;
+    while (leaves > 1 && leaves / 2 >= span)
+        leaves /= 2;
+    layoutLevels();
+
+    Bucket empty;
+    empty.count = 0;
+    empty.min = std::numeric_limits<qint64>::max();
+    empty.max = std::numeric_limits<qint64>::min();
+    buckets.fill(empty);
+
+    // 第二遍：填充最底层
+    Bucket* leaf = buckets.data();
+    const double scale = leaves / span;
+    for (qint64 i = 0; any && i < rows; ++i)
+    {
+        qint64 v;
+        if (!element(i, &v))
+            continue;
+        const int k = qMin(int((double(v) - double(dataMin)) * scale), leaves - 1);
+        Bucket& b = leaf[k];
+        ++b.count;
+        b.min = qMin(b.min, v);
+        b.max = qMax(b.max, v);
+    }
+
+    // 自底向上合并相邻的两个桶
+    for (int index = 1; index < levelOffsets.size(); ++index)
+    {
+        const Bucket* below = level(index - 1);
+        Bucket* current = buckets.data() + levelOffsets.at(index);
+        for (int k = 0; k < levelSize(index); ++k)
+        {
+            const Bucket& a = below[2 * k];
+            const Bucket& b = below[2 * k + 1];
+            current[k].count = a.count + b.count;
+            current[k].min = qMin(a.min, b.min);
+            current[k].max = qMax(a.max, b.max);
+        }
+    }
+}
+
+bool QxtSpanColumnSource::savePyramid() const
+{
+    QSaveFile out(pyramidFileName());
+    if (!out.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream stream(&out);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << PyramidMagic << PyramidVersion << qint32(type) << file.size() << lastModified << rows
+           << qint32(requestedLeaves) << dataMin << dataMax << qint32(leaves);
+    for (int i = 0; i < buckets.size(); ++i)
+    {
+        const Bucket& b = buckets.at(i);
+        stream << b.count << b.min << b.max;
+    }
+    if (stream.status() != QDataStream::Ok)
+    {
+        out.cancelWriting();
+        return false;
+    }
+    return out.commit();
+}
+
+void QxtSpanColumnSource::layoutLevels()
+{
+    // 各层依次为 leaves、leaves / 2、……、1 个桶
+    levelOffsets.clear();
+    int offset = 0;
+    for (int size = leaves; size >= 1; size /= 2)
+    {
+        levelOffsets.append(offset);
+        offset += size;
+    }
+    buckets.resize(offset);
+}
+
+const QxtSpanColumnSource::Bucket* QxtSpanColumnSource::level(int index) const
+{
+    return buckets.constData() + levelOffsets.at(index);
+}
+
+int QxtSpanColumnSource::levelSize(int index) const
+{
+    return leaves >> index;
+}
@@ -0,0 +1,114 @@
+#ifndef QXTSPANDATASOURCE_H
+#define QXTSPANDATASOURCE_H
+
+#include <QFile>
+#include <QReadWriteLock>
+#include <QString>
+#include <QVector>
+
+QT_FORWARD_DECLARE_CLASS(QObject)
+QT_FORWARD_DECLARE_CLASS(QThreadPool)
+
+// QxtSpanDataSource 描述滑块范围轴上的数据分布，供叠加层和范围自动缩放使用。
+// 实现必须允许在多个线程中同时调用 const 函数。
+class QxtSpanDataSource {
+public:
+    virtual ~QxtSpanDataSource(); // 析构函数
+
+    // 数据源是否可用
+    virtual bool isValid() const = 0;
+
+    // 元素总数以及元素的最小值和最大值
+    virtual qint64 count() const = 0;
+    virtual qint64 minimum() const = 0;
+    virtual qint64 maximum() const = 0;
+
+    // 把 [from, to] 等分为 bins 个区间，返回落在每个区间内的元素数量
+    virtual QVector<qreal> histogram(qint64 from, qint64 to, int bins) const = 0;
+};
+
+// QxtSpanColumnSource 以内存映射方式打开一个二进制数值列文件（本机字节序的定长元素），
+// 并构建或加载保存在旁路文件中的多分辨率 min/max/count 金字塔。
+// 打开之后所有查询只访问金字塔，耗时与请求的区间数成正比，与列的大小无关。
+class QxtSpanColumnSource : public QxtSpanDataSource {
+public:
+    // 枚举：列文件的元素类型
+    enum ElementType {
+        Int32,
+        Int64,
+        Float,
+        Double
+    };
+
+    // 构造函数，leafCount 为金字塔最底层的桶数，向上取整为 2 的幂
+    QxtSpanColumnSource(const QString& fileName, ElementType type, int leafCount = 16384);
+    virtual ~QxtSpanColumnSource(); // 析构函数
+
+    // 映射列文件并加载金字塔；旁路文件不存在或已过时时重新构建并保存。
+    // open() 和 close() 执行期间，其他线程中的查询不会阻塞，而是把数据源视为不可用
+    bool open();
+    void close();
+
+    // 在线程池中调用 open()，完成后以排队连接调用 receiver 的 member(bool)。构建金字塔需要扫描整个列，
+    // 不应在 GUI 线程中进行
+    void openAsync(QObject* receiver = 0, const char* member = 0, QThreadPool* pool = 0);
+    QString errorString() const;
+
+    // 获取列文件和旁路文件的路径
+    QString fileName() const;
+    QString pyramidFileName() const;
+
+    // 金字塔的层数，第 0 层为最底层
+    int levelCount() const;
+
+    // 通过内存映射按需读取第 row 个元素，浮点数向下取整
+    qint64 value(qint64 row) const;
+
+    // QxtSpanDataSource 接口
+    virtual bool isValid() const;
+    virtual qint64 count() const;
+    virtual qint64 minimum() const;
+    virtual qint64 maximum() const;
+    virtual QVector<qreal> histogram(qint64 from, qint64 to, int bins) const;
+
+private:
+    Q_DISABLE_COPY(QxtSpanColumnSource)
+
+    // 金字塔中的一个桶：元素数量以及桶内元素的实际最小值和最大值
+    struct Bucket
+    {
+        qint64 count;
+        qint64 min;
+        qint64 max;
+    };
+
+    void reset();
+    int elementSize() const;
+    bool element(qint64 index, qint64* value) const;
+    bool loadPyramid();
+    void buildPyramid();
+    bool savePyramid() const;
+    void layoutLevels();
+    const Bucket* level(int index) const;
+    int levelSize(int index) const;
+
+    // 保护下面所有的状态：open() 和 close() 持有写锁，查询尝试获取读锁，获取不到时返回不可用的结果
+    mutable QReadWriteLock lock;
+
+    QFile file;
+    ElementType type;
+    int requestedLeaves;
+    uchar* data;
+    qint64 rows;
+    qint64 lastModified;
+    QString error;
+
+    // 金字塔：各层的桶依次存放，levelOffsets[i] 为第 i 层第一个桶的下标
+    qint64 dataMin;
+    qint64 dataMax;
+    int leaves;
+    QVector<Bucket> buckets;
+    QVector<int> levelOffsets;
+};
+
+#endif // QXTSPANDATASOURCE_H
@@ -0,0 +1,609 @@
+#include "QxtSpanFilter.h"
+#include "QxtSpanSlider.h"
+#include <QAtomicInt>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+#include <QtAlgorithms>
+#include <cmath>
+#include <functional>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define QXT_SPANFILTER_SSE2
+#  include <emmintrin.h>
+#endif
+
+#if defined(QXT_SPANFILTER_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#  define QXT_SPANFILTER_AVX2
+#  include <immintrin.h>
+#  define QXT_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace
+{
+// 每个块处理 64 个元素，块内结果正好是一个 64 位掩码字
+const qint64 BlockSize = 64;
+
+// 多线程时每个线程至少处理的元素数
+const qint64 MinimumChunk = 1 << 16;
+
+template <typename T>
+struct Bounds
+{
+    T lo;
+    T hi;
+};
+
+// 整数列直接使用 int 范围
+template <typename T>
+Bounds<T> makeBounds(int lower, int upper)
+{
+    Bounds<T> b = { T(lower), T(upper) };
+    return b;
+}
+
+// 浮点列取不小于 lower 的最小值和不大于 upper 的最大值，避免 int 到 float 的舍入误差
+template <>
+Bounds<float> makeBounds<float>(int lower, int upper)
+{
+    float lo = float(lower);
+    float hi = float(upper);
+    if (double(lo) < lower)
+        lo = std::nextafter(lo, HUGE_VALF);
+    if (double(hi) > upper)
+        hi = std::nextafter(hi, -HUGE_VALF);
+    Bounds<float> b = { lo, hi };
+    return b;
+}
+
+// 标量实现，处理不足一个块的尾部元素
+template <typename T>
+quint64 scalarBlock(const T* p, qint64 n, T lo, T hi)
+{
+    quint64 bits = 0;
+    for (qint64 i = 0; i < n; ++i)
+    {
+        if (p[i] >= lo && p[i] <= hi)
+            bits |= quint64(1) << i;
+    }
+    return bits;
+}
+
+template <typename T>
+quint64 scalarBlock64(const T* p, T lo, T hi)
+{
+    return scalarBlock(p, BlockSize, lo, hi);
+}
+
+#ifdef QXT_SPANFILTER_SSE2
+quint64 sse2Block64(const qint32* p, qint32 lo, qint32 hi)
+{
+    const __m128i vlo = _mm_set1_epi32(lo);
+    const __m128i vhi = _mm_set1_epi32(hi);
+    quint64 bits = 0;
+    for (int i = 0; i < BlockSize; i += 4)
+    {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        const __m128i out = _mm_or_si128(_mm_cmplt_epi32(x, vlo), _mm_cmpgt_epi32(x, vhi));
+        bits |= quint64(~_mm_movemask_ps(_mm_castsi128_ps(out)) & 0xF) << i;
+    }
+    return bits;
+}
+
+quint64 sse2Block64(const float* p, float lo, float hi)
+{
+    const __m128 vlo = _mm_set1_ps(lo);
+    const __m128 vhi = _mm_set1_ps(hi);
+    quint64 bits = 0;
+    for (int i = 0; i < BlockSize; i += 4)
+    {
+        const __m128 x = _mm_loadu_ps(p + i);
+        const __m128 in = _mm_and_ps(_mm_cmpge_ps(x, vlo), _mm_cmple_ps(x, vhi));
+        bits |= quint64(_mm_movemask_ps(in)) << i;
+    }
+    return bits;
+}
+
+quint64 sse2Block64(const double* p, double lo, double hi)
+{
+    const __m128d vlo = _mm_set1_pd(lo);
+    const __m128d vhi = _mm_set1_pd(hi);
+    quint64 bits = 0;
+    for (int i = 0; i < BlockSize; i += 2)
+    {
+        const __m128d x = _mm_loadu_pd(p + i);
+        const __m128d in = _mm_and_pd(_mm_cmpge_pd(x, vlo), _mm_cmple_pd(x, vhi));
+        bits |= quint64(_mm_movemask_pd(in)) << i;
+    }
+    return bits;
+}
+#endif
+
+#ifdef QXT_SPANFILTER_AVX2
+QXT_TARGET_AVX2 quint64 avx2Block64(const qint32* p, qint32 lo, qint32 hi)
+{
+    const __m256i vlo = _mm256_set1_epi32(lo);
+    const __m256i vhi = _mm256_set1_epi32(hi);
+    quint64 bits = 0;
+    for (int i = 0; i < BlockSize; i += 8)
+    {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        const __m256i out = _mm256_or_si256(_mm256_cmpgt_epi32(vlo, x), _mm256_cmpgt_epi32(x, vhi));
+        bits |= quint64(~_mm256_movemask_ps(_mm256_castsi256_ps(out)) & 0xFF) << i;
+    }
+    return bits;
+}
+
+QXT_TARGET_AVX2 quint64 avx2Block64(const qint64* p, qint64 lo, qint64 hi)
+{
+    const __m256i vlo = _mm256_set1_epi64x(lo);
+    const __m256i vhi = _mm256_set1_epi64x(hi);
+    quint64 bits = 0;
+    for (int i = 0; i < BlockSize; i += 4)
+    {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        const __m256i out = _mm256_or_si256(_mm256_cmpgt_epi64(vlo, x), _mm256_cmpgt_epi64(x, vhi));
+        bits |= quint64(~_mm256_movemask_pd(_mm256_castsi256_pd(out)) & 0xF) << i;
+    }
+    return bits;
+}
+
+QXT_TARGET_AVX2 quint64 avx2Block64(const float* p, float lo, float hi)
+{
+    const __m256 vlo = _mm256_set1_ps(lo);
+    const __m256 vhi = _mm256_set1_ps(hi);
+    quint64 bits = 0;
+    for (int i = 0; i < BlockSize; i += 8)
+    {
+        const __m256 x = _mm256_loadu_ps(p + i);
+        const __m256 in = _mm256_and_ps(_mm256_cmp_ps(x, vlo, _CMP_GE_OQ), _mm256_cmp_ps(x, vhi, _CMP_LE_OQ));
+        bits |= quint64(_mm256_movemask_ps(in)) << i;
+    }
+    return bits;
+}
+
+QXT_TARGET_AVX2 quint64 avx2Block64(const double* p, double lo, double hi)
+{
+    const __m256d vlo = _mm256_set1_pd(lo);
+    const __m256d vhi = _mm256_set1_pd(hi);
+    quint64 bits = 0;
+    for (int i = 0; i < BlockSize; i += 4)
+    {
+        const __m256d x = _mm256_loadu_pd(p + i);
+        const __m256d in = _mm256_and_pd(_mm256_cmp_pd(x, vlo, _CMP_GE_OQ), _mm256_cmp_pd(x, vhi, _CMP_LE_OQ));
+        bits |= quint64(_mm256_movemask_pd(in)) << i;
+    }
+    return bits;
+}
+#endif
+
+// setKernel() 设置的内核上限，默认不做限制
+QBasicAtomicInt kernelLimit = Q_BASIC_ATOMIC_INITIALIZER(QxtSpanFilter::Avx2Kernel);
+
+QxtSpanFilter::Kernel detectKernel()
+{
+#if defined(QXT_SPANFILTER_AVX2)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return QxtSpanFilter::Avx2Kernel;
+#endif
+#if defined(QXT_SPANFILTER_SSE2)
+    return QxtSpanFilter::Sse2Kernel;
+#else
+    return QxtSpanFilter::ScalarKernel;
+#endif
+}
+
+// 按处理器选择每种类型的块内核，SSE2 没有 64 位整数比较，qint64 在 SSE2 下使用标量实现
+template <typename T>
+struct BlockFunction
+{
+    typedef quint64 (*Type)(const T*, T, T);
+};
+
+#ifdef QXT_SPANFILTER_AVX2
+#  define QXT_AVX2_BLOCK(T) case QxtSpanFilter::Avx2Kernel: return static_cast<BlockFunction<T>::Type>(avx2Block64);
+#else
+#  define QXT_AVX2_BLOCK(T)
+#endif
+
+#ifdef QXT_SPANFILTER_SSE2
+#  define QXT_SSE2_BLOCK(T) case QxtSpanFilter::Sse2Kernel: return static_cast<BlockFunction<T>::Type>(sse2Block64);
+#else
+#  define QXT_SSE2_BLOCK(T)
+#endif
+
+template <typename T>
+typename BlockFunction<T>::Type blockFunction();
+
+template <>
+BlockFunction<qint32>::Type blockFunction<qint32>()
+{
+    switch (QxtSpanFilter::kernel())
+    {
+    QXT_AVX2_BLOCK(qint32)
+    QXT_SSE2_BLOCK(qint32)
+    default:
+        return scalarBlock64<qint32>;
+    }
+}
+
+template <>
+BlockFunction<qint64>::Type blockFunction<qint64>()
+{
+    switch (QxtSpanFilter::kernel())
+    {
+    QXT_AVX2_BLOCK(qint64)
+    default:
+        return scalarBlock64<qint64>;
+    }
+}
+
+template <>
+BlockFunction<float>::Type blockFunction<float>()
+{
+    switch (QxtSpanFilter::kernel())
+    {
+    QXT_AVX2_BLOCK(float)
+    QXT_SSE2_BLOCK(float)
+    default:
+        return scalarBlock64<float>;
+    }
+}
+
+template <>
+BlockFunction<double>::Type blockFunction<double>()
+{
+    switch (QxtSpanFilter::kernel())
+    {
+    QXT_AVX2_BLOCK(double)
+    QXT_SSE2_BLOCK(double)
+    default:
+        return scalarBlock64<double>;
+    }
+}
+
+// 依次扫描 [begin, end) 中的每个块，begin 必须是 BlockSize 的整数倍
+template <typename T, typename Sink>
+void scan(const T* data, qint64 begin, qint64 end, const Bounds<T>& bounds, Sink& sink)
+{
+    const typename BlockFunction<T>::Type block = blockFunction<T>();
+    qint64 i = begin;
+    for (; i + BlockSize <= end; i += BlockSize)
+        sink(i, block(data + i, bounds.lo, bounds.hi));
+    if (i < end)
+        sink(i, scalarBlock(data + i, end - i, bounds.lo, bounds.hi));
+}
+
+struct CountSink
+{
+    qint64 count;
+    void operator()(qint64, quint64 bits) { count += qPopulationCount(bits); }
+};
+
+struct MaskSink
+{
+    quint64* bits;
+    void operator()(qint64 i, quint64 word) { bits[i / BlockSize] = word; }
+};
+
+struct IndexSink
+{
+    QVector<qint64>* indices;
+    void operator()(qint64 i, quint64 bits)
+    {
+        while (bits)
+        {
+            indices->append(i + qCountTrailingZeroBits(bits));
+            bits &= bits - 1;
+        }
+    }
+};
+
+class ChunkTask : public QRunnable {
+public:
+    ChunkTask(const std::function<void ()>& work, QSemaphore* done) : work(work), done(done) {}
+    virtual void run()
+    {
+        work();
+        done->release();
+    }
+
+private:
+    std::function<void ()> work;
+    QSemaphore* done;
+};
+
+// 把 [0, size) 按块对齐切分为若干段，在线程池中并行执行 work(段号, 起点, 终点)，当前线程执行最后一段。
+// 只用 tryStart() 把段交给立即可用的线程，线程池饱和时其余的段在当前线程中执行，
+// 因此从线程池的工作线程中调用也不会因为等待永远不会开始的任务而死锁
+int chunkCount(qint64 size, int threads)
+{
+    if (threads <= 0)
+        threads = QThread::idealThreadCount();
+    return int(qBound<qint64>(1, size / MinimumChunk, qMax(1, threads)));
+}
+
+void runChunks(qint64 size, int chunks, const std::function<void (int, qint64, qint64)>& work)
+{
+    qint64 chunkSize = (size + chunks - 1) / chunks;
+    chunkSize = (chunkSize + BlockSize - 1) / BlockSize * BlockSize;
+
+    QSemaphore done;
+    int started = 0;
+    for (int c = 0; c < chunks - 1; ++c)
+    {
+        const qint64 begin = c * chunkSize;
+        const qint64 end = qMin(size, begin + chunkSize);
+        ChunkTask* task = new ChunkTask(std::bind(work, c, begin, end), &done);
+        if (QThreadPool::globalInstance()->tryStart(task))
+        {
+            ++started;
+        }
+        else
+        {
+            delete task;
+            work(c, begin, end);
+        }
+    }
+    work(chunks - 1, qMin(size, (chunks - 1) * chunkSize), size);
+    done.acquire(started);
+}
+
+template <typename T>
+qint64 countSpan(const T* data, qint64 size, int lower, int upper, int threads)
+{
+    const Bounds<T> bounds = makeBounds<T>(lower, upper);
+    const int chunks = chunkCount(size, threads);
+    QVector<qint64> counts(chunks, 0);
+    qint64* results = counts.data();
+    runChunks(size, chunks, [&](int c, qint64 begin, qint64 end) {
+        CountSink sink = { 0 };
+        scan(data, begin, end, bounds, sink);
+        results[c] = sink.count;
+    });
+
+    qint64 total = 0;
+    for (int c = 0; c < chunks; ++c)
+        total += counts.at(c);
+    return total;
+}
+
+template <typename T>
+void maskSpan(const T* data, qint64 size, quint64* bits, int lower, int upper, int threads)
+{
+    const Bounds<T> bounds = makeBounds<T>(lower, upper);
+    runChunks(size, chunkCount(size, threads), [&](int, qint64 begin, qint64 end) {
+        MaskSink sink = { bits };
+        scan(data, begin, end, bounds, sink);
+    });
+}
+
+template <typename T>
+QVector<qint64> indexSpan(const T* data, qint64 size, int lower, int upper, int threads)
+{
+    const Bounds<T> bounds = makeBounds<T>(lower, upper);
+    const int chunks = chunkCount(size, threads);
+    QVector<QVector<qint64> > parts(chunks);
+    QVector<qint64>* results = parts.data();
+    runChunks(size, chunks, [&](int c, qint64 begin, qint64 end) {
+        IndexSink sink = { results + c };
+        scan(data, begin, end, bounds, sink);
+    });
+
+    if (chunks == 1)
+        return parts.first();
+    int total = 0;
+    for (int c = 0; c < chunks; ++c)
+        total += parts.at(c).size();
+    QVector<qint64> indices;
+    indices.reserve(total);
+    for (int c = 0; c < chunks; ++c)
+        indices += parts.at(c);
+    return indices;
+}
+} // namespace
+
+/*!
+    \class QxtSpanFilter
+    \inmodule QxtWidgets
+    \brief QxtSpanFilter 将 QxtSpanSlider 的范围应用到连续存储的数值列上。
+
+    QxtSpanFilter 对 qint32、qint64、float 和 double 数组计算 [lower(), upper()] 闭区间的过滤结果，
+    可以输出位掩码、选中元素的下标或选中元素的数量。浮点数中的 NaN 永远不会被选中。
+
+    计算内核在运行时按处理器选择：支持 AVX2 时使用 AVX2，否则在 x86 上使用 SSE2，其余平台使用标量实现。
+    设置 threadCount() 后，较大的数组会按 64 个元素对齐切分，在全局线程池中并行处理。
+
+    QxtSpanFilter 可以直接在 spanChanged() 的槽函数中构造：
+    \code
+    void Viewer::onSpanChanged(int lower, int upper)
+    {
+        QxtSpanFilter filter(lower, upper);
+        filter.setThreadCount(0);
+        selected = filter.indices(column.constData(), column.size());
+    }
+    \endcode
+ */
+
+/*!
+    \enum QxtSpanFilter::Kernel
+    此枚举描述了可用的计算内核。
+    \value ScalarKernel 标量实现。
+    \value Sse2Kernel SSE2 实现，qint64 列仍使用标量实现。
+    \value Avx2Kernel AVX2 实现。
+ */
+
+/*!
+    构造一个选择 \a lower 到 \a upper 闭区间的过滤器。两个值的顺序无关紧要。
+ */
+QxtSpanFilter::QxtSpanFilter(int lower, int upper) :
+        lo(qMin(lower, upper)),
+        hi(qMax(lower, upper)),
+        threads(1)
+{
+}
+
+/*!
+    构造一个使用 \a slider 当前范围的过滤器。
+ */
+QxtSpanFilter::QxtSpanFilter(const QxtSpanSlider* slider) :
+        lo(slider->lowerValue()),
+        hi(slider->upperValue()),
+        threads(1)
+{
+}
+
+/*!
+    返回范围的下限值。
+ */
+int QxtSpanFilter::lower() const
+{
+    return lo;
+}
+
+/*!
+    返回范围的上限值。
+ */
+int QxtSpanFilter::upper() const
+{
+    return hi;
+}
+
+/*!
+    返回并行处理使用的线程数。默认值为 1，即在调用线程中完成所有计算。
+ */
+int QxtSpanFilter::threadCount() const
+{
+    return threads;
+}
+
+/*!
+    设置并行处理使用的线程数 \a count。0 表示使用 QThread::idealThreadCount()。
+    每个线程至少处理 65536 个元素，较小的数组总是在调用线程中处理。
+
+    并行的部分在 QThreadPool::globalInstance() 中执行，但只使用当时空闲的线程，其余部分由调用线程自己完成，
+    因此可以在全局线程池的工作线程中（例如 QtConcurrent::run() 里）调用，不会死锁。
+ */
+void QxtSpanFilter::setThreadCount(int count)
+{
+    threads = qMax(0, count);
+}
+
+/*!
+    返回 \a data 的前 \a size 个元素中位于范围内的元素数量。
+ */
+qint64 QxtSpanFilter::count(const qint32* data, qint64 size) const
+{
+    return countSpan(data, size, lo, hi, threads);
+}
+
+/*!
+    \overload
+ */
+qint64 QxtSpanFilter::count(const qint64* data, qint64 size) const
+{
+    return countSpan(data, size, lo, hi, threads);
+}
+
+/*!
+    \overload
+ */
+qint64 QxtSpanFilter::count(const float* data, qint64 size) const
+{
+    return countSpan(data, size, lo, hi, threads);
+}
+
+/*!
+    \overload
+ */
+qint64 QxtSpanFilter::count(const double* data, qint64 size) const
+{
+    return countSpan(data, size, lo, hi, threads);
+}
+
+/*!
+    将 \a data 的前 \a size 个元素的过滤结果写入位掩码 \a bits。
+    \a bits 至少需要 (size + 63) / 64 个字，最后一个字中超出 \a size 的位为 0。
+ */
+void QxtSpanFilter::mask(const qint32* data, qint64 size, quint64* bits) const
+{
+    maskSpan(data, size, bits, lo, hi, threads);
+}
+
+/*!
+    \overload
+ */
+void QxtSpanFilter::mask(const qint64* data, qint64 size, quint64* bits) const
+{
+    maskSpan(data, size, bits, lo, hi, threads);
+}
+
+/*!
+    \overload
+ */
+void QxtSpanFilter::mask(const float* data, qint64 size, quint64* bits) const
+{
+    maskSpan(data, size, bits, lo, hi, threads);
+}
+
+/*!
+    \overload
+ */
+void QxtSpanFilter::mask(const double* data, qint64 size, quint64* bits) const
+{
+    maskSpan(data, size, bits, lo, hi, threads);
+}
+
+/*!
+    按升序返回 \a data 的前 \a size 个元素中位于范围内的元素下标。
+ */
+QVector<qint64> QxtSpanFilter::indices(const qint32* data, qint64 size) const
+{
+    return indexSpan(data, size, lo, hi, threads);
+}
+
+/*!
+    \overload
+ */
+QVector<qint64> QxtSpanFilter::indices(const qint64* data, qint64 size) const
+{
+    return indexSpan(data, size, lo, hi, threads);
+}
+
+/*!
+    \overload
+ */
+QVector<qint64> QxtSpanFilter::indices(const float* data, qint64 size) const
+{
+    return indexSpan(data, size, lo, hi, threads);
+}
+
+/*!
+    \overload
+ */
+QVector<qint64> QxtSpanFilter::indices(const double* data, qint64 size) const
+{
+    return indexSpan(data, size, lo, hi, threads);
+}
+
+/*!
+    返回当前处理器上选用的计算内核。检测只在第一次调用时进行。
+
+    \sa setKernel()
+ */
+QxtSpanFilter::Kernel QxtSpanFilter::kernel()
+{
+    static const Kernel detected = detectKernel();
+    return Kernel(qMin(int(detected), kernelLimit.load()));
+}
+
+/*!
+    把可选用的最高内核限制为 \a kernel，之后的过滤使用处理器支持的内核中不高于 \a kernel 的最好的一个。
+    传入 Avx2Kernel 取消限制。主要用于比较各内核的性能和排查问题，设置对所有 QxtSpanFilter 生效。
+ */
+void QxtSpanFilter::setKernel(Kernel kernel)
+{
+    kernelLimit.store(kernel);
+}
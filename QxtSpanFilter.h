@@ -0,0 +1,62 @@
+#ifndef QXTSPANFILTER_H
+#define QXTSPANFILTER_H
+
+#include <QtGlobal>
+#include <QVector>
+
+// 前向声明
+class QxtSpanSlider;
+
+// QxtSpanFilter 将 [lower, upper] 范围应用到连续存储的数值列上，
+// 结果可以是位掩码、选中行的下标或选中行的数量
+class QxtSpanFilter {
+public:
+    // 枚举：运行时选用的计算内核
+    enum Kernel {
+        ScalarKernel,   // 标量实现
+        Sse2Kernel,     // SSE2 实现
+        Avx2Kernel      // AVX2 实现
+    };
+
+    // 构造函数
+    QxtSpanFilter(int lower, int upper);
+    explicit QxtSpanFilter(const QxtSpanSlider* slider);
+
+    // 获取范围
+    int lower() const;
+    int upper() const;
+
+    // 获取和设置线程数，1 表示单线程，0 表示使用 QThread::idealThreadCount()
+    int threadCount() const;
+    void setThreadCount(int count);
+
+    // 统计范围内的元素数量
+    qint64 count(const qint32* data, qint64 size) const;
+    qint64 count(const qint64* data, qint64 size) const;
+    qint64 count(const float* data, qint64 size) const;
+    qint64 count(const double* data, qint64 size) const;
+
+    // 生成位掩码：第 i 个元素在范围内时 bits[i / 64] 的第 i % 64 位为 1，bits 需要 (size + 63) / 64 个字
+    void mask(const qint32* data, qint64 size, quint64* bits) const;
+    void mask(const qint64* data, qint64 size, quint64* bits) const;
+    void mask(const float* data, qint64 size, quint64* bits) const;
+    void mask(const double* data, qint64 size, quint64* bits) const;
+
+    // 按升序返回范围内元素的下标
+    QVector<qint64> indices(const qint32* data, qint64 size) const;
+    QVector<qint64> indices(const qint64* data, qint64 size) const;
+    QVector<qint64> indices(const float* data, qint64 size) const;
+    QVector<qint64> indices(const double* data, qint64 size) const;
+
+    // 获取当前处理器上选用的内核
+    static Kernel kernel();
+    // 限制可选用的最高内核，用于基准测试和排查问题
+    static void setKernel(Kernel kernel);
+
+private:
+    int lo;
+    int hi;
+    int threads;
+};
+
+#endif // QXTSPANFILTER_H
@@ -0,0 +1,462 @@
+#include "QxtSpanFilterProxyModel.h"
+#include "QxtSpanSlider.h"
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+// 按过滤列的值排序源模型行，值相同时保持源模型中的顺序
+struct KeyLess
+{
+    const QVector<double>* values;
+    bool operator()(int a, int b) const
+    {
+        return values->at(a) < values->at(b);
+    }
+};
+} // namespace
+
+/*!
+    \class QxtSpanFilterProxyModel
+    \inmodule QxtWidgets
+    \brief QxtSpanFilterProxyModel 是一个按 QxtSpanSlider 范围增量过滤的代理模型。
+
+    QxtSpanFilterProxyModel 只显示 filterKeyColumn() 列的值位于 [lowerValue(), upperValue()] 闭区间内的行。
+    它为该列维护一个排序索引，代理模型中的行按该列的值升序排列，因此可见行总是排序索引中的一个连续区间。
+
+    范围从 [a, b] 变为 [c, d] 时，只有两个区间的对称差中的行被插入或移除，
+    并且以 beginInsertRows()/beginRemoveRows() 的连续块通知视图。
+    每次过滤的代价取决于滑块移动经过的行数，而与模型大小无关。
+
+    源模型的行、列或过滤列的数据发生变化时，排序索引会被重建并重置代理模型。
+    重置在源模型发出 rowsAboutToBeRemoved() 等“即将变化”的信号时就开始，
+    因此视图不会在源模型变化之后、重置之前用旧的映射访问已经不存在的源行。
+    源模型的布局变化（例如排序）不会重置代理模型，而是转发为 layoutChanged() 并更新持久索引。
+    只支持列表和表格这样的平面模型。
+
+    \code
+    QxtSpanFilterProxyModel* proxy = new QxtSpanFilterProxyModel(this);
+    proxy->setSourceModel(model);
+    proxy->setFilterKeyColumn(2);
+    proxy->setSpanSlider(slider);
+    view->setModel(proxy);
+    \endcode
+ */
+
+/*!
+    使用 \a parent 构造一个新的 QxtSpanFilterProxyModel。初始范围包含所有行。
+ */
+QxtSpanFilterProxyModel::QxtSpanFilterProxyModel(QObject* parent) :
+        QAbstractProxyModel(parent),
+        column(0),
+        role(Qt::DisplayRole),
+        lower(std::numeric_limits<int>::min()),
+        upper(std::numeric_limits<int>::max()),
+        first(0),
+        last(0),
+        resetting(false),
+        layoutChanging(false)
+{
+}
+
+/*!
+    销毁 QxtSpanFilterProxyModel 对象。
+ */
+QxtSpanFilterProxyModel::~QxtSpanFilterProxyModel()
+{
+}
+
+/*!
+    返回绑定的滑块，未绑定时返回 0。
+ */
+QxtSpanSlider* QxtSpanFilterProxyModel::spanSlider() const
+{
+    return slider;
+}
+
+/*!
+    将过滤范围绑定到 \a slider 的 spanChanged() 信号，并立即使用它的当前范围。
+ */
+void QxtSpanFilterProxyModel::setSpanSlider(QxtSpanSlider* slider)
+{
+    if (this->slider == slider)
+        return;
+
+    if (this->slider)
+        disconnect(this->slider, SIGNAL(spanChanged(int, int)), this, SLOT(setSpan(int, int)));
+    this->slider = slider;
+    if (slider)
+    {
+        connect(slider, SIGNAL(spanChanged(int, int)), this, SLOT(setSpan(int, int)));
+        setSpan(slider->lowerValue(), slider->upperValue());
+    }
+}
+
+/*!
+    \property QxtSpanFilterProxyModel::filterKeyColumn
+    \brief 用于过滤和排序的源模型列，默认值为 0
+ */
+int QxtSpanFilterProxyModel::filterKeyColumn() const
+{
+    return column;
+}
+
+void QxtSpanFilterProxyModel::setFilterKeyColumn(int column)
+{
+    if (this->column != column)
+    {
+        this->column = column;
+        rebuild();
+    }
+}
+
+/*!
+    \property QxtSpanFilterProxyModel::filterRole
+    \brief 读取过滤列的值时使用的数据角色，默认值为 Qt::DisplayRole
+ */
+int QxtSpanFilterProxyModel::filterRole() const
+{
+    return role;
+}
+
+void QxtSpanFilterProxyModel::setFilterRole(int role)
+{
+    if (this->role != role)
+    {
+        this->role = role;
+        rebuild();
+    }
+}
+
+/*!
+    \property QxtSpanFilterProxyModel::lowerValue
+    \brief 过滤范围的下限值
+ */
+int QxtSpanFilterProxyModel::lowerValue() const
+{
+    return lower;
+}
+
+/*!
+    \property QxtSpanFilterProxyModel::upperValue
+    \brief 过滤范围的上限值
+ */
+int QxtSpanFilterProxyModel::upperValue() const
+{
+    return upper;
+}
+
+/*!
+    \reimp
+ */
+void QxtSpanFilterProxyModel::setSourceModel(QAbstractItemModel* sourceModel)
+{
+    QAbstractItemModel* old = this->sourceModel();
+    if (old)
+        disconnect(old, 0, this, 0);
+    if (resetting)
+    {
+        // 旧的源模型在变化途中被替换，先结束未完成的重置
+        buildIndex();
+        resetting = false;
+        endResetModel();
+    }
+
+    QAbstractProxyModel::setSourceModel(sourceModel);
+
+    if (sourceModel)
+    {
+        connect(sourceModel, SIGNAL(dataChanged(QModelIndex, QModelIndex)), this, SLOT(sourceDataChanged(QModelIndex, QModelIndex)));
+        connect(sourceModel, SIGNAL(headerDataChanged(Qt::Orientation, int, int)), this, SLOT(sourceHeaderDataChanged(Qt::Orientation, int, int)));
+        connect(sourceModel, SIGNAL(rowsAboutToBeInserted(QModelIndex, int, int)), this, SLOT(sourceAboutToChange()));
+        connect(sourceModel, SIGNAL(rowsInserted(QModelIndex, int, int)), this, SLOT(sourceChanged()));
+        connect(sourceModel, SIGNAL(rowsAboutToBeRemoved(QModelIndex, int, int)), this, SLOT(sourceAboutToChange()));
+        connect(sourceModel, SIGNAL(rowsRemoved(QModelIndex, int, int)), this, SLOT(sourceChanged()));
+        connect(sourceModel, SIGNAL(rowsAboutToBeMoved(QModelIndex, int, int, QModelIndex, int)), this, SLOT(sourceAboutToChange()));
+        connect(sourceModel, SIGNAL(rowsMoved(QModelIndex, int, int, QModelIndex, int)), this, SLOT(sourceChanged()));
+        connect(sourceModel, SIGNAL(columnsAboutToBeInserted(QModelIndex, int, int)), this, SLOT(sourceAboutToChange()));
+        connect(sourceModel, SIGNAL(columnsInserted(QModelIndex, int, int)), this, SLOT(sourceChanged()));
+        connect(sourceModel, SIGNAL(columnsAboutToBeRemoved(QModelIndex, int, int)), this, SLOT(sourceAboutToChange()));
+        connect(sourceModel, SIGNAL(columnsRemoved(QModelIndex, int, int)), this, SLOT(sourceChanged()));
+        connect(sourceModel, SIGNAL(columnsAboutToBeMoved(QModelIndex, int, int, QModelIndex, int)), this, SLOT(sourceAboutToChange()));
+        connect(sourceModel, SIGNAL(columnsMoved(QModelIndex, int, int, QModelIndex, int)), this, SLOT(sourceChanged()));
+        connect(sourceModel, SIGNAL(modelAboutToBeReset()), this, SLOT(sourceAboutToChange()));
+        connect(sourceModel, SIGNAL(modelReset()), this, SLOT(sourceChanged()));
+        connect(sourceModel, SIGNAL(layoutAboutToBeChanged()), this, SLOT(sourceLayoutAboutToBeChanged()));
+        connect(sourceModel, SIGNAL(layoutChanged()), this, SLOT(sourceLayoutChanged()));
+    }
+    rebuild();
+}
+
+/*!
+    \reimp
+ */
+QModelIndex QxtSpanFilterProxyModel::mapToSource(const QModelIndex& proxyIndex) const
+{
+    if (!proxyIndex.isValid() || !sourceModel())
+        return QModelIndex();
+    return sourceModel()->index(rows.at(first + proxyIndex.row()), proxyIndex.column());
+}
+
+/*!
+    \reimp
+ */
+QModelIndex QxtSpanFilterProxyModel::mapFromSource(const QModelIndex& sourceIndex) const
+{
+    if (!sourceIndex.isValid() || sourceIndex.parent().isValid() || sourceIndex.row() >= ranks.size())
+        return QModelIndex();
+    const int pos = ranks.at(sourceIndex.row());
+    if (pos < first || pos >= last)
+        return QModelIndex();
+    return createIndex(pos - first, sourceIndex.column());
+}
+
+/*!
+    \reimp
+ */
+QModelIndex QxtSpanFilterProxyModel::index(int row, int column, const QModelIndex& parent) const
+{
+    if (parent.isValid() || row < 0 || row >= rowCount() || column < 0 || column >= columnCount())
+        return QModelIndex();
+    return createIndex(row, column);
+}
+
+/*!
+    \reimp
+ */
+QModelIndex QxtSpanFilterProxyModel::parent(const QModelIndex& child) const
+{
+    Q_UNUSED(child);
+    return QModelIndex();
+}
+
+/*!
+    \reimp
+ */
+int QxtSpanFilterProxyModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : last - first;
+}
+
+/*!
+    \reimp
+ */
+int QxtSpanFilterProxyModel::columnCount(const QModelIndex& parent) const
+{
+    if (parent.isValid() || !sourceModel())
+        return 0;
+    return sourceModel()->columnCount();
+}
+
+/*!
+    \reimp
+ */
+bool QxtSpanFilterProxyModel::hasChildren(const QModelIndex& parent) const
+{
+    return !parent.isValid() && last > first;
+}
+
+/*!
+    设置过滤范围，从 \a lower 到 \a upper。
+    只有进入或离开范围的行会被插入或移除，开销为 O(log n) 加上变化的行数。
+ */
+void QxtSpanFilterProxyModel::setSpan(int lower, int upper)
+{
+    this->lower = qMin(lower, upper);
+    this->upper = qMax(lower, upper);
+
+    const double low = this->lower;
+    const double upp = this->upper;
+    const int newFirst = int(std::lower_bound(keys.constBegin(), keys.constEnd(), low) - keys.constBegin());
+    const int newLast = int(std::upper_bound(keys.constBegin(), keys.constEnd(), upp) - keys.constBegin());
+    moveWindow(newFirst, newLast);
+}
+
+void QxtSpanFilterProxyModel::moveWindow(int newFirst, int newLast)
+{
+    const QModelIndex root;
+    if (newLast <= newFirst)
+        newLast = newFirst;
+
+    // 新旧区间不相交时，先移除全部旧行再插入全部新行
+    if (last <= first || newLast <= newFirst || newFirst >= last || newLast <= first)
+    {
+        if (last > first)
+        {
+            beginRemoveRows(root, 0, last - first - 1);
+            first = last = newFirst;
+            endRemoveRows();
+        }
+        if (newLast > newFirst)
+        {
+            beginInsertRows(root, 0, newLast - newFirst - 1);
+            first = newFirst;
+            last = newLast;
+            endInsertRows();
+        }
+        first = newFirst;
+        last = newLast;
+        return;
+    }
+
+    // 区间相交时，在两端各自收缩或扩展
+    if (newFirst > first)
+    {
+        beginRemoveRows(root, 0, newFirst - first - 1);
+        first = newFirst;
+        endRemoveRows();
+    }
+    if (newLast < last)
+    {
+        beginRemoveRows(root, newLast - first, last - first - 1);
+        last = newLast;
+        endRemoveRows();
+    }
+    if (newFirst < first)
+    {
+        beginInsertRows(root, 0, first - newFirst - 1);
+        first = newFirst;
+        endInsertRows();
+    }
+    if (newLast > last)
+    {
+        beginInsertRows(root, last - first, newLast - first - 1);
+        last = newLast;
+        endInsertRows();
+    }
+}
+
+void QxtSpanFilterProxyModel::rebuild()
+{
+    // 源模型变化途中的重建推迟到 sourceChanged()
+    if (resetting)
+        return;
+    beginResetModel();
+    buildIndex();
+    endResetModel();
+}
+
+void QxtSpanFilterProxyModel::sourceAboutToChange()
+{
+    if (resetting)
+        return;
+    beginResetModel();
+    resetting = true;
+
+    // 旧的索引指向即将失效的源行，重置结束之前不再使用
+    keys.clear();
+    rows.clear();
+    ranks.clear();
+    first = last = 0;
+}
+
+void QxtSpanFilterProxyModel::sourceChanged()
+{
+    if (!resetting)
+    {
+        rebuild();
+        return;
+    }
+    buildIndex();
+    resetting = false;
+    endResetModel();
+}
+
+void QxtSpanFilterProxyModel::sourceLayoutAboutToBeChanged()
+{
+    if (resetting || layoutChanging)
+        return;
+    layoutChanging = true;
+    emit layoutAboutToBeChanged();
+
+    // 记住每个代理持久索引对应的源索引，布局变化后按源索引重新映射
+    layoutProxyIndexes = persistentIndexList();
+    layoutSourceIndexes.clear();
+    for (int i = 0; i < layoutProxyIndexes.size(); ++i)
+        layoutSourceIndexes.append(QPersistentModelIndex(mapToSource(layoutProxyIndexes.at(i))));
+}
+
+void QxtSpanFilterProxyModel::sourceLayoutChanged()
+{
+    // 没有先发出 layoutAboutToBeChanged() 的源模型只能按重置处理
+    if (!layoutChanging)
+    {
+        rebuild();
+        return;
+    }
+    layoutChanging = false;
+    buildIndex();
+
+    QModelIndexList mapped;
+    for (int i = 0; i < layoutSourceIndexes.size(); ++i)
+        mapped.append(mapFromSource(layoutSourceIndexes.at(i)));
+    changePersistentIndexList(layoutProxyIndexes, mapped);
+    layoutProxyIndexes.clear();
+    layoutSourceIndexes.clear();
+    emit layoutChanged();
+}
+
+void QxtSpanFilterProxyModel::buildIndex()
+{
+    keys.clear();
+    rows.clear();
+    ranks.clear();
+    first = last = 0;
+
+    const QAbstractItemModel* model = sourceModel();
+    if (model && column >= 0 && column < model->columnCount())
+    {
+        const int count = model->rowCount();
+        QVector<double> values(count);
+        rows.resize(count);
+        for (int row = 0; row < count; ++row)
+        {
+            values[row] = model->index(row, column).data(role).toDouble();
+            rows[row] = row;
+        }
+
+        KeyLess less = { &values };
+        std::stable_sort(rows.begin(), rows.end(), less);
+
+        keys.resize(count);
+        ranks.resize(count);
+        for (int pos = 0; pos < count; ++pos)
+        {
+            keys[pos] = values.at(rows.at(pos));
+            ranks[rows.at(pos)] = pos;
+        }
+
+        first = int(std::lower_bound(keys.constBegin(), keys.constEnd(), double(lower)) - keys.constBegin());
+        last = int(std::upper_bound(keys.constBegin(), keys.constEnd(), double(upper)) - keys.constBegin());
+        if (last < first)
+            last = first;
+    }
+}
+
+void QxtSpanFilterProxyModel::sourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight)
+{
+    if (topLeft.parent().isValid())
+        return;
+
+    // 过滤列的值变化会改变排序，必须重建索引
+    if (column >= topLeft.column() && column <= bottomRight.column())
+    {
+        rebuild();
+        return;
+    }
+
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row)
+    {
+        const QModelIndex left = mapFromSource(sourceModel()->index(row, topLeft.column()));
+        if (left.isValid())
+            emit dataChanged(left, index(left.row(), bottomRight.column()));
+    }
+}
+
+void QxtSpanFilterProxyModel::sourceHeaderDataChanged(Qt::Orientation orientation, int firstSection, int lastSection)
+{
+    if (orientation == Qt::Horizontal)
+        emit headerDataChanged(orientation, firstSection, lastSection);
+    else if (rowCount() > 0)
+        emit headerDataChanged(orientation, 0, rowCount() - 1);
+}
@@ -0,0 +1,103 @@
+#ifndef QXTSPANFILTERPROXYMODEL_H
+#define QXTSPANFILTERPROXYMODEL_H
+
+#include <QAbstractProxyModel>
+#include <QPersistentModelIndex>
+#include <QPointer>
+#include <QVector>
+
+// 前向声明
+class QxtSpanSlider;
+
+// QxtSpanFilterProxyModel 只显示数值列位于 [lowerValue(), upperValue()] 内的源模型行，
+// 行按该列的值升序排列，范围变化时只插入或移除移动经过的行
+class QxtSpanFilterProxyModel : public QAbstractProxyModel {
+    Q_OBJECT
+
+    // 属性声明，用于集成 Qt 的属性系统
+    Q_PROPERTY(int filterKeyColumn READ filterKeyColumn WRITE setFilterKeyColumn)
+    Q_PROPERTY(int filterRole READ filterRole WRITE setFilterRole)
+    Q_PROPERTY(int lowerValue READ lowerValue)
+    Q_PROPERTY(int upperValue READ upperValue)
+
+public:
+    // 构造函数
+    explicit QxtSpanFilterProxyModel(QObject* parent = 0);
+    virtual ~QxtSpanFilterProxyModel(); // 析构函数
+
+    // 获取和设置绑定的滑块
+    QxtSpanSlider* spanSlider() const;
+    void setSpanSlider(QxtSpanSlider* slider);
+
+    // 获取和设置过滤的列和角色
+    int filterKeyColumn() const;
+    void setFilterKeyColumn(int column);
+    int filterRole() const;
+    void setFilterRole(int role);
+
+    // 获取当前的过滤范围
+    int lowerValue() const;
+    int upperValue() const;
+
+    // QAbstractProxyModel 接口
+    virtual void setSourceModel(QAbstractItemModel* sourceModel);
+    virtual QModelIndex mapToSource(const QModelIndex& proxyIndex) const;
+    virtual QModelIndex mapFromSource(const QModelIndex& sourceIndex) const;
+    virtual QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const;
+    virtual QModelIndex parent(const QModelIndex& child) const;
+    virtual int rowCount(const QModelIndex& parent = QModelIndex()) const;
+    virtual int columnCount(const QModelIndex& parent = QModelIndex()) const;
+    virtual bool hasChildren(const QModelIndex& parent = QModelIndex()) const;
+
+public Q_SLOTS:
+    // 设置过滤范围，从 lower 到 upper
+    void setSpan(int lower, int upper);
+
+private Q_SLOTS:
+    // 过滤列或角色变化时重建排序索引并重置代理模型
+    void rebuild();
+
+    // 源模型的行或列即将变化时开始重置，变化完成后重建排序索引并结束重置
+    void sourceAboutToChange();
+    void sourceChanged();
+
+    // 转发源模型的布局变化，保持代理模型的持久索引
+    void sourceLayoutAboutToBeChanged();
+    void sourceLayoutChanged();
+
+    // 转发源模型的数据变化
+    void sourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight);
+    void sourceHeaderDataChanged(Qt::Orientation orientation, int firstSection, int lastSection);
+
+private:
+    // 将可见区间调整为排序索引中的 [newFirst, newLast)
+    void moveWindow(int newFirst, int newLast);
+
+    // 按当前的源模型、列和角色建立排序索引，不发出任何信号
+    void buildIndex();
+
+    QPointer<QxtSpanSlider> slider;
+    int column;
+    int role;
+    int lower;
+    int upper;
+
+    // 排序索引：keys 升序排列，rows[i] 为对应的源模型行，ranks[源模型行] 为其在索引中的位置
+    QVector<double> keys;
+    QVector<int> rows;
+    QVector<int> ranks;
+
+    // 可见行在排序索引中的区间 [first, last)
+    int first;
+    int last;
+
+    // 是否处于由源模型变化引起的重置或布局变化之中
+    bool resetting;
+    bool layoutChanging;
+
+    // 布局变化期间保存的代理持久索引及其对应的源模型索引
+    QModelIndexList layoutProxyIndexes;
+    QList<QPersistentModelIndex> layoutSourceIndexes;
+};
+
+#endif // QXTSPANFILTERPROXYMODEL_H
@@ -30,12 +30,72 @@
 *****************************************************************************/
 
 #include "QxtSpanSlider_p.h"
+#include "QxtSpanSliderOverlay.h"
+#include "QxtSpanSliderOverlay_p.h"
+#include "QxtSpanSliderTrace.h"
+#include "QxtSpanSliderLogic_p.h"
 #include <QKeyEvent>
 #include <QMouseEvent>
 #include <QApplication>
 #include <QStylePainter>
 #include <QStyleOptionSlider>
 #include <QStylePainter>
+#include <QFontMetrics>
+#include <QDateTime>
+#include <QAtomicInt>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
+
+namespace
+{
+// 批量渲染的共享状态：各线程（包括调用线程）依次领取下一小批图像，直到全部领完
+struct RenderBatches
+{
+    enum { BatchSize = 16 };
+
+    const QxtSpanSliderRenderOptions* options;
+    QImage* images;
+    int count;
+    QStyle* style;
+    QAtomicInt next;
+
+    void renderAll()
+    {
+        for (int begin = next.fetchAndAddRelaxed(BatchSize); begin < count; begin = next.fetchAndAddRelaxed(BatchSize))
+        {
+            const int end = qMin(begin + int(BatchSize), count);
+            for (int i = begin; i < end; ++i)
+            {
+                QxtSpanSliderRenderOptions opt = options[i];
+                if (!opt.style)
+                    opt.style = style;
+                images[i] = QxtSpanSlider::renderImage(opt);
+            }
+        }
+    }
+};
+
+// 在工作线程中参与批量渲染
+class RenderTask : public QRunnable {
+public:
+    RenderTask(RenderBatches* batches, QSemaphore* done) :
+            batches(batches),
+            done(done)
+    {
+    }
+
+    virtual void run()
+    {
+        batches->renderAll();
+        done->release();
+    }
+
+private:
+    RenderBatches* batches;
+    QSemaphore* done;
+};
+} // namespace
 
 QxtSpanSliderPrivate::QxtSpanSliderPrivate() :
         lower(0),
@@ -48,10 +108,35 @@ QxtSpanSliderPrivate::QxtSpanSliderPrivate() :
         mainControl(QxtSpanSlider::LowerHandle),
         lowerPressed(QStyle::SC_None),
         upperPressed(QStyle::SC_None),
+        spanPressed(false),
+        spanPressValue(0),
+        spanPressLower(0),
         movement(QxtSpanSlider::FreeMovement),
         firstMovement(false),
-        blockTracking(false)
+        blockTracking(false),
+        updateDepth(0),
+        rangeStaged(false),
+        spanStaged(false),
+        stagedLower(0),
+        stagedUpper(0),
+        tickLabelsVisible(false),
+        valueReadoutsVisible(false),
+        labelsDirty(true),
+        timeAxis(false),
+        overlayPool(0),
+        overlayScheduled(false),
+        quantileMode(false),
+        prefetchHorizon(200),
+        prefetchValid(false),
+        prefetchLower(0),
+        prefetchUpper(0)
+{
+}
+
+QxtSpanSliderPrivate::~QxtSpanSliderPrivate()
 {
+    // 工作线程可能仍在访问叠加层，必须等待其结束
+    cancelOverlay();
 }
 
 void QxtSpanSliderPrivate::initStyleOption(QStyleOptionSlider* option, QxtSpanSlider::SpanHandle handle) const
@@ -62,31 +147,53 @@ void QxtSpanSliderPrivate::initStyleOption(QStyleOptionSlider* option, QxtSpanSl
     option->sliderValue = (handle == QxtSpanSlider::LowerHandle ? lower : upper);
 }
 
-int QxtSpanSliderPrivate::pixelPosToRangeValue(int pos) const
+void QxtSpanSliderPrivate::sliderGeometry(int* sliderMin, int* sliderMax, int* sliderLength, bool* upsideDown) const
 {
     QStyleOptionSlider opt;
     initStyleOption(&opt);
+    *upsideDown = opt.upsideDown;
 
-    int sliderMin = 0;
-    int sliderMax = 0;
-    int sliderLength = 0;
     const QSlider* p = q_ptr;
     const QRect gr = p->style()->subControlRect(QStyle::CC_Slider, &opt, QStyle::SC_SliderGroove, p);
     const QRect sr = p->style()->subControlRect(QStyle::CC_Slider, &opt, QStyle::SC_SliderHandle, p);
     if (p->orientation() == Qt::Horizontal)
     {
-        sliderLength = sr.width();
-        sliderMin = gr.x();
-        sliderMax = gr.right() - sliderLength + 1;
+        *sliderLength = sr.width();
+        *sliderMin = gr.x();
+        *sliderMax = gr.right() - *sliderLength + 1;
     }
     else
     {
-        sliderLength = sr.height();
-        sliderMin = gr.y();
-        sliderMax = gr.bottom() - sliderLength + 1;
+        *sliderLength = sr.height();
+        *sliderMin = gr.y();
+        *sliderMax = gr.bottom() - *sliderLength + 1;
     }
+}
+
+int QxtSpanSliderPrivate::pixelPosToRangeValue(int pos) const
+{
+    int sliderMin = 0;
+    int sliderMax = 0;
+    int sliderLength = 0;
+    bool upsideDown = false;
+    sliderGeometry(&sliderMin, &sliderMax, &sliderLength, &upsideDown);
+
+    const QSlider* p = q_ptr;
     return QStyle::sliderValueFromPosition(p->minimum(), p->maximum(), pos - sliderMin,
-                                           sliderMax - sliderMin, opt.upsideDown);
+                                           sliderMax - sliderMin, upsideDown);
+}
+
+int QxtSpanSliderPrivate::rangeValueToPixelPos(int value) const
+{
+    int sliderMin = 0;
+    int sliderMax = 0;
+    int sliderLength = 0;
+    bool upsideDown = false;
+    sliderGeometry(&sliderMin, &sliderMax, &sliderLength, &upsideDown);
+
+    const QSlider* p = q_ptr;
+    return sliderMin + sliderLength / 2 + QStyle::sliderPositionFromValue(p->minimum(), p->maximum(), value,
+                                                                          sliderMax - sliderMin, upsideDown);
 }
 
 void QxtSpanSliderPrivate::handleMousePress(const QPoint& pos, QStyle::SubControl& control, int value, QxtSpanSlider::SpanHandle handle)
@@ -109,9 +216,44 @@ void QxtSpanSliderPrivate::handleMousePress(const QPoint& pos, QStyle::SubContro
         p->update(sr);
 }
 
-void QxtSpanSliderPrivate::setupPainter(QPainter* painter, Qt::Orientation orientation, qreal x1, qreal y1, qreal x2, qreal y2) const
+void QxtSpanSliderPrivate::trackMotion(qint64 timestamp)
+{
+    QxtSpanSlider* p = q_ptr;
+    motion.addSample(lowerPos, upperPos, timestamp, qreal(p->maximum()) - p->minimum());
+    if (prefetchHorizon <= 0)
+        return;
+
+    const QPair<int, int> predicted = p->predictedSpan(prefetchHorizon);
+    if (prefetchValid && predicted.first >= prefetchLower && predicted.second <= prefetchUpper)
+        return;
+
+    // 新窗口覆盖当前跨度和预测跨度，两端再各留出半个跨度宽度，避免每一步都重新预取
+    const qint64 low = qMin(qMin(lowerPos, upperPos), predicted.first);
+    const qint64 upp = qMax(qMax(lowerPos, upperPos), predicted.second);
+    const qint64 margin = qAbs(qint64(upperPos) - lowerPos) / 2;
+    prefetchLower = int(qMax(qint64(p->minimum()), low - margin));
+    prefetchUpper = int(qMin(qint64(p->maximum()), upp + margin));
+    prefetchValid = true;
+    emit p->prefetchRequested(prefetchLower, prefetchUpper);
+}
+
+bool QxtSpanSliderPrivate::hitSpan(const QPoint& pos) const
 {
-    QColor highlight = q_ptr->palette().color(QPalette::Highlight);
+    QStyleOptionSlider opt;
+    initStyleOption(&opt);
+    const QxtSpanSlider* p = q_ptr;
+    QRect handle;
+    const QRect span = spanRect(p->style(), opt, lowerPos, upperPos, p, &handle);
+
+    // 跨度只画成细条，命中区域在垂直于滑槽的方向上扩展到滑块柄的厚度
+    if (p->orientation() == Qt::Horizontal)
+        return QRect(span.left(), handle.top(), span.width(), handle.height()).contains(pos);
+    return QRect(handle.left(), span.top(), handle.width(), span.height()).contains(pos);
+}
+
+void QxtSpanSliderPrivate::setupPainter(QPainter* painter, const QPalette& palette, Qt::Orientation orientation, qreal x1, qreal y1, qreal x2, qreal y2)
+{
+    QColor highlight = palette.color(QPalette::Highlight);
     QLinearGradient gradient(x1, y1, x2, y2);
     gradient.setColorAt(0, highlight.dark(120));
     gradient.setColorAt(1, highlight.light(108));
@@ -123,152 +265,463 @@ void QxtSpanSliderPrivate::setupPainter(QPainter* painter, Qt::Orientation orien
         painter->setPen(QPen(highlight.dark(150), 0));
 }
 
-void QxtSpanSliderPrivate::drawSpan(QStylePainter* painter, const QRect& rect) const
+QRect QxtSpanSliderPrivate::spanRect(QStyle* style, const QStyleOptionSlider& option, int lowerPos, int upperPos,
+                                     const QWidget* widget, QRect* handleRect)
 {
-    QStyleOptionSlider opt;
-    initStyleOption(&opt);
-    const QSlider* p = q_ptr;
+    QStyleOptionSlider opt = option;
 
-    // area
-    QRect groove = p->style()->subControlRect(QStyle::CC_Slider, &opt, QStyle::SC_SliderGroove, p);
+    // 计算下限滑块的矩形区域
+    opt.sliderPosition = lowerPos;
+    const QRect lr = style->subControlRect(QStyle::CC_Slider, &opt, QStyle::SC_SliderHandle, widget);
+    const int lrv  = (opt.orientation == Qt::Horizontal) ? lr.center().x() : lr.center().y();
+
+    // 计算上限滑块的矩形区域
+    opt.sliderPosition = upperPos;
+    const QRect ur = style->subControlRect(QStyle::CC_Slider, &opt, QStyle::SC_SliderHandle, widget);
+    const int urv  = (opt.orientation == Qt::Horizontal) ? ur.center().x() : ur.center().y();
+
+    if (handleRect)
+        *handleRect = lr;
+
+    // 计算 span（滑块之间的范围）的矩形区域
+    const int minv = qMin(lrv, urv);
+    const int maxv = qMax(lrv, urv);
+    const QPoint c = QRect(lr.center(), ur.center()).center();
     if (opt.orientation == Qt::Horizontal)
+        return QRect(QPoint(minv, c.y() - 2), QPoint(maxv, c.y() + 1));
+    return QRect(QPoint(c.x() - 2, minv), QPoint(c.x() + 1, maxv));
+}
+
+void QxtSpanSliderPrivate::drawSpan(QPainter* painter, QStyle* style, const QStyleOptionSlider& option, const QRect& rect, const QWidget* widget)
+{
+    QXT_SPANSLIDER_TRACE_SCOPE("paintEvent/span");
+
+    // area
+    QRect groove = style->subControlRect(QStyle::CC_Slider, &option, QStyle::SC_SliderGroove, widget);
+    if (option.orientation == Qt::Horizontal)
         groove.adjust(0, 0, -1, 0);
     else
         groove.adjust(0, 0, 0, -1);
 
     // pen & brush
-    painter->setPen(QPen(p->palette().color(QPalette::Dark).light(110), 0));
-    if (opt.orientation == Qt::Horizontal)
-        setupPainter(painter, opt.orientation, groove.center().x(), groove.top(), groove.center().x(), groove.bottom());
+    painter->setPen(QPen(option.palette.color(QPalette::Dark).light(110), 0));
+    if (option.orientation == Qt::Horizontal)
+        setupPainter(painter, option.palette, option.orientation, groove.center().x(), groove.top(), groove.center().x(), groove.bottom());
     else
-        setupPainter(painter, opt.orientation, groove.left(), groove.center().y(), groove.right(), groove.center().y());
+        setupPainter(painter, option.palette, option.orientation, groove.left(), groove.center().y(), groove.right(), groove.center().y());
 
     // draw groove
     painter->drawRect(rect.intersected(groove));
 }
 
-void QxtSpanSliderPrivate::drawHandle(QStylePainter* painter, QxtSpanSlider::SpanHandle handle) const
+void QxtSpanSliderPrivate::drawHandle(QPainter* painter, QStyle* style, const QStyleOptionSlider& option, const PaintState& state,
+                                      QxtSpanSlider::SpanHandle handle, const QWidget* widget)
 {
-    QStyleOptionSlider opt;
-    initStyleOption(&opt, handle);
+    QXT_SPANSLIDER_TRACE_SCOPE(handle == QxtSpanSlider::LowerHandle ? "paintEvent/lowerHandle" : "paintEvent/upperHandle");
+    QStyleOptionSlider opt = option;
+    opt.sliderPosition = (handle == QxtSpanSlider::LowerHandle ? state.lowerPos : state.upperPos);
+    opt.sliderValue = (handle == QxtSpanSlider::LowerHandle ? state.lower : state.upper);
     opt.subControls = QStyle::SC_SliderHandle;
-    QStyle::SubControl pressed = (handle == QxtSpanSlider::LowerHandle ? lowerPressed : upperPressed);
+    QStyle::SubControl pressed = (handle == QxtSpanSlider::LowerHandle ? state.lowerPressed : state.upperPressed);
     if (pressed == QStyle::SC_SliderHandle)
     {
         opt.activeSubControls = pressed;
         opt.state |= QStyle::State_Sunken;
     }
-    painter->drawComplexControl(QStyle::CC_Slider, opt);
+    style->drawComplexControl(QStyle::CC_Slider, &opt, painter, widget);
 }
 
-void QxtSpanSliderPrivate::triggerAction(QAbstractSlider::SliderAction action, bool main)
+void QxtSpanSliderPrivate::paintSlider(QPainter* painter, QStyle* style, const QStyleOptionSlider& option, const PaintState& state, const QWidget* widget)
 {
-    int value = 0;
-    bool no = false;
-    bool up = false;
-    const int min = q_ptr->minimum();
-    const int max = q_ptr->maximum();
-    const QxtSpanSlider::SpanHandle altControl = (mainControl == QxtSpanSlider::LowerHandle ? QxtSpanSlider::UpperHandle : QxtSpanSlider::LowerHandle);
+    QStyleOptionSlider opt = option;
 
-    blockTracking = true;
+    // 绘制滑槽和刻度标记
+    opt.sliderValue = 0;
+    opt.sliderPosition = 0;
+    opt.subControls = QStyle::SC_SliderGroove | QStyle::SC_SliderTickmarks;
+    {
+        QXT_SPANSLIDER_TRACE_SCOPE("paintEvent/groove");
+        style->drawComplexControl(QStyle::CC_Slider, &opt, painter, widget);
+    }
+
+    // 绘制 span（滑块之间的范围）的外观
+    drawSpan(painter, style, option, spanRect(style, opt, state.lowerPos, state.upperPos, widget), widget);
 
-    switch (action)
+    // 根据最后一个被按下的滑块，绘制滑块的外观
+    switch (state.lastPressed)
     {
-    case QAbstractSlider::SliderSingleStepAdd:
-        if ((main && mainControl == QxtSpanSlider::UpperHandle) || (!main && altControl == QxtSpanSlider::UpperHandle))
-        {
-            value = qBound(min, upper + q_ptr->singleStep(), max);
-            up = true;
-            break;
-        }
-        value = qBound(min, lower + q_ptr->singleStep(), max);
-        break;
-    case QAbstractSlider::SliderSingleStepSub:
-        if ((main && mainControl == QxtSpanSlider::UpperHandle) || (!main && altControl == QxtSpanSlider::UpperHandle))
-        {
-            value = qBound(min, upper - q_ptr->singleStep(), max);
-            up = true;
-            break;
-        }
-        value = qBound(min, lower - q_ptr->singleStep(), max);
-        break;
-    case QAbstractSlider::SliderToMinimum:
-        value = min;
-        if ((main && mainControl == QxtSpanSlider::UpperHandle) || (!main && altControl == QxtSpanSlider::UpperHandle))
-            up = true;
-        break;
-    case QAbstractSlider::SliderToMaximum:
-        value = max;
-        if ((main && mainControl == QxtSpanSlider::UpperHandle) || (!main && altControl == QxtSpanSlider::UpperHandle))
-            up = true;
-        break;
-    case QAbstractSlider::SliderMove:
-        if ((main && mainControl == QxtSpanSlider::UpperHandle) || (!main && altControl == QxtSpanSlider::UpperHandle))
-            up = true;
-    case QAbstractSlider::SliderNoAction:
-        no = true;
+    case QxtSpanSlider::LowerHandle:
+        // 优先绘制上限滑块，然后绘制下限滑块
+        drawHandle(painter, style, option, state, QxtSpanSlider::UpperHandle, widget);
+        drawHandle(painter, style, option, state, QxtSpanSlider::LowerHandle, widget);
         break;
+    case QxtSpanSlider::UpperHandle:
     default:
-        qWarning("QxtSpanSliderPrivate::triggerAction: Unknown action");
+        // 优先绘制下限滑块，然后绘制上限滑块
+        drawHandle(painter, style, option, state, QxtSpanSlider::LowerHandle, widget);
+        drawHandle(painter, style, option, state, QxtSpanSlider::UpperHandle, widget);
         break;
     }
+}
+
+void QxtSpanSliderPrivate::triggerAction(QAbstractSlider::SliderAction action, bool main)
+{
+    QXT_SPANSLIDER_TRACE_SCOPE("triggerAction");
+    const bool up = QxtSpanSliderLogic::targetsUpper(main, mainControl);
+
+    blockTracking = true;
+
+    int value = 0;
+    if (QxtSpanSliderLogic::actionValue(action, up ? upper : lower, q_ptr->singleStep(),
+                                        q_ptr->minimum(), q_ptr->maximum(), &value))
+        moveHandle(up, value, lower, upper);
 
-    if (!no && !up)
+    blockTracking = false;
+    q_ptr->setLowerValue(lowerPos);
+    q_ptr->setUpperValue(upperPos);
+}
+
+void QxtSpanSliderPrivate::moveHandle(bool upperHandle, int value, int lowerBound, int upperBound)
+{
+    // 按移动模式限制；自由移动时越过另一个滑块柄则交换控制，值作用于另一个滑块柄
+    const QxtSpanSliderLogic::Move move = QxtSpanSliderLogic::moveHandle(movement, upperHandle, value, lowerBound, upperBound);
+    if (move.swap)
+        swapControls();
+    if (upperHandle != move.swap)
+        q_ptr->setUpperPosition(move.value);
+    else
+        q_ptr->setLowerPosition(move.value);
+}
+
+void QxtSpanSliderPrivate::swapControls()
+{
+    qSwap(lower, upper);
+    qSwap(lowerPressed, upperPressed);
+    lastPressed = (lastPressed == QxtSpanSlider::LowerHandle ? QxtSpanSlider::UpperHandle : QxtSpanSlider::LowerHandle);
+    mainControl = (mainControl == QxtSpanSlider::LowerHandle ? QxtSpanSlider::UpperHandle : QxtSpanSlider::LowerHandle);
+}
+
+QString QxtSpanSliderPrivate::formatValue(int value) const
+{
+    if (formatter)
+        return formatter(value);
+    if (timeAxis)
+        return QDateTime::fromSecsSinceEpoch(value).toString(QLatin1String("yyyy-MM-dd hh:mm:ss"));
+    if (quantileMode && !sketch.isEmpty())
+        return QString::number(sketch.quantile(valueToQuantile(value)), 'g', 6);
+    return QString::number(value);
+}
+
+qreal QxtSpanSliderPrivate::valueToQuantile(int value) const
+{
+    const QxtSpanSlider* p = q_ptr;
+    if (p->maximum() <= p->minimum())
+        return 0;
+    return qBound<qreal>(0, (qreal(value) - p->minimum()) / (qreal(p->maximum()) - p->minimum()), 1);
+}
+
+const QStaticText& QxtSpanSliderPrivate::staticText(const QString& text) const
+{
+    QHash<QString, QStaticText>::iterator it = textCache.find(text);
+    if (it == textCache.end())
     {
-        if (movement == QxtSpanSlider::NoCrossing)
-            value = qMin(value, upper);
-        else if (movement == QxtSpanSlider::NoOverlapping)
-            value = qMin(value, upper - 1);
+        // 拖动时读数文本不断变化，限制缓存的大小
+        if (textCache.size() >= 512)
+            textCache.clear();
+
+        QStaticText staticText(text);
+        staticText.setTextFormat(Qt::PlainText);
+        staticText.prepare(QTransform(), q_ptr->font());
+        it = textCache.insert(text, staticText);
+    }
+    return it.value();
+}
 
-        if (movement == QxtSpanSlider::FreeMovement && value > upper)
-        {
-            swapControls();
-            q_ptr->setUpperPosition(value);
-        }
-        else
-        {
-            q_ptr->setLowerPosition(value);
-        }
+int QxtSpanSliderPrivate::labelStripHeight() const
+{
+    return q_ptr->fontMetrics().height() + 2;
+}
+
+int QxtSpanSliderPrivate::labelStripWidth() const
+{
+    const QFontMetrics fm = q_ptr->fontMetrics();
+    const int minWidth = fm.boundingRect(formatValue(q_ptr->minimum())).width();
+    const int maxWidth = fm.boundingRect(formatValue(q_ptr->maximum())).width();
+    return qMax(minWidth, maxWidth) + 4;
+}
+
+void QxtSpanSliderPrivate::invalidateLabels()
+{
+    labelsDirty = true;
+}
+
+void QxtSpanSliderPrivate::layoutTickLabels() const
+{
+    const QxtSpanSlider* p = q_ptr;
+    int interval = p->tickInterval();
+    if (interval <= 0)
+        interval = p->pageStep();
+    if (timeAxis)
+        interval = -1;
+
+    int sliderMin = 0;
+    int sliderMax = 0;
+    int sliderLength = 0;
+    bool upsideDown = false;
+    sliderGeometry(&sliderMin, &sliderMax, &sliderLength, &upsideDown);
+
+    // 只有尺寸、范围或刻度间隔变化时才重新布局
+    LabelLayoutKey key = { p->size(), p->minimum(), p->maximum(), interval, p->orientation(), upsideDown };
+    if (!labelsDirty && key == labelKey)
+        return;
+    labelKey = key;
+    labelsDirty = false;
+    tickLabels.clear();
+
+    // 时间轴模式使用已缓存的日历刻度
+    if (timeAxis)
+    {
+        updateTimeTicks();
+        const QVector<qint64>& values = timeTicks.values();
+        const QVector<int>& positions = timeTicks.positions();
+        for (int i = 0; i < values.size(); ++i)
+            appendTickLabel(timeTicks.label(values.at(i)), positions.at(i));
+        return;
+    }
+
+    const int span = sliderMax - sliderMin;
+    if (interval <= 0 || span <= 0 || p->minimum() >= p->maximum())
+        return;
+
+    // 按端点标签估计所需间距，将刻度间隔放大整数倍以避免标签重叠
+    const int extent = (p->orientation() == Qt::Horizontal) ? labelStripWidth() + 4 : labelStripHeight() + 2;
+    const qint64 range = qint64(p->maximum()) - p->minimum();
+    const qint64 maxLabels = qMax(1, span / qMax(1, extent));
+    const qint64 multiple = qMax<qint64>(1, (range + maxLabels * interval - 1) / (maxLabels * interval));
+    const qint64 step = multiple * interval;
+
+    for (qint64 v = p->minimum(); v <= p->maximum(); v += step)
+    {
+        const int pos = sliderMin + sliderLength / 2
+                      + QStyle::sliderPositionFromValue(p->minimum(), p->maximum(), int(v), span, upsideDown);
+        appendTickLabel(formatValue(int(v)), pos);
+    }
+}
+
+void QxtSpanSliderPrivate::appendTickLabel(const QString& text, int pos) const
+{
+    const QxtSpanSlider* p = q_ptr;
+    TickLabel label;
+    label.text = text;
+    const QSizeF size = staticText(label.text).size();
+    if (p->orientation() == Qt::Horizontal)
+    {
+        const qreal x = qBound<qreal>(0, pos - size.width() / 2, p->width() - size.width());
+        label.pos = QPointF(x, p->height() - size.height());
     }
-    else if (!no)
+    else
     {
-        if (movement == QxtSpanSlider::NoCrossing)
-            value = qMax(value, lower);
-        else if (movement == QxtSpanSlider::NoOverlapping)
-            value = qMax(value, lower + 1);
+        const qreal y = qBound<qreal>(0, pos - size.height() / 2, p->height() - size.height());
+        label.pos = QPointF(p->width() - labelStripWidth() + 2, y);
+    }
+    tickLabels.append(label);
+}
+
+void QxtSpanSliderPrivate::updateTimeTicks() const
+{
+    int sliderMin = 0;
+    int sliderMax = 0;
+    int sliderLength = 0;
+    bool upsideDown = false;
+    sliderGeometry(&sliderMin, &sliderMax, &sliderLength, &upsideDown);
+
+    // 相邻刻度至少间隔一个日期标签的宽度（垂直方向为一行的高度）
+    const QxtSpanSlider* p = q_ptr;
+    const int spacing = (p->orientation() == Qt::Horizontal)
+                      ? p->fontMetrics().boundingRect(QLatin1String("0000-00-00")).width() + 8
+                      : labelStripHeight() + 2;
+    timeTicks.update(p->minimum(), p->maximum(), sliderMin + sliderLength / 2, sliderMax - sliderMin, upsideDown, spacing);
+}
+
+void QxtSpanSliderPrivate::drawTimeTicks(QPainter* painter, const QStyleOptionSlider& option) const
+{
+    QXT_SPANSLIDER_TRACE_SCOPE("paintEvent/timeTicks");
+    if (option.tickPosition == QSlider::NoTicks)
+        return;
+
+    updateTimeTicks();
+
+    // 与 QCommonStyle 绘制刻度线的位置保持一致
+    const QxtSpanSlider* p = q_ptr;
+    const int thickness = p->style()->pixelMetric(QStyle::PM_SliderControlThickness, &option, p);
+    const int tickOffset = p->style()->pixelMetric(QStyle::PM_SliderTickmarkOffset, &option, p);
+    const QVector<int>& positions = timeTicks.positions();
 
-        if (movement == QxtSpanSlider::FreeMovement && value < lower)
+    painter->setPen(option.palette.color(QPalette::WindowText));
+    for (int i = 0; i < positions.size(); ++i)
+    {
+        const int pos = positions.at(i);
+        if (option.orientation == Qt::Horizontal)
         {
-            swapControls();
-            q_ptr->setLowerPosition(value);
+            if (option.tickPosition & QSlider::TicksAbove)
+                painter->drawLine(pos, 0, pos, tickOffset - 2);
+            if (option.tickPosition & QSlider::TicksBelow)
+                painter->drawLine(pos, tickOffset + thickness + 1, pos, option.rect.height() - 1);
         }
         else
         {
-            q_ptr->setUpperPosition(value);
+            if (option.tickPosition & QSlider::TicksAbove)
+                painter->drawLine(0, pos, tickOffset - 2, pos);
+            if (option.tickPosition & QSlider::TicksBelow)
+                painter->drawLine(tickOffset + thickness + 1, pos, option.rect.width() - 1, pos);
         }
     }
+}
+
+void QxtSpanSliderPrivate::drawTickLabels(QPainter* painter) const
+{
+    QXT_SPANSLIDER_TRACE_SCOPE("paintEvent/tickLabels");
+    layoutTickLabels();
+
+    painter->setPen(q_ptr->palette().color(QPalette::WindowText));
+    for (int i = 0; i < tickLabels.size(); ++i)
+        painter->drawStaticText(tickLabels.at(i).pos, staticText(tickLabels.at(i).text));
+}
+
+void QxtSpanSliderPrivate::drawValueReadouts(QPainter* painter) const
+{
+    QXT_SPANSLIDER_TRACE_SCOPE("paintEvent/readouts");
+    const QxtSpanSlider* p = q_ptr;
+    const int positions[2] = { lowerPos, upperPos };
+
+    painter->setPen(p->palette().color(QPalette::WindowText));
+    for (int i = 0; i < 2; ++i)
+    {
+        const QStaticText& text = staticText(formatValue(positions[i]));
+        const QSizeF size = text.size();
+        const int pos = rangeValueToPixelPos(positions[i]);
+        QPointF topLeft;
+        if (p->orientation() == Qt::Horizontal)
+            topLeft = QPointF(qBound<qreal>(0, pos - size.width() / 2, p->width() - size.width()), 0);
+        else
+            topLeft = QPointF(labelStripWidth() - 2 - size.width(), qBound<qreal>(0, pos - size.height() / 2, p->height() - size.height()));
+        painter->drawStaticText(topLeft, text);
+    }
+}
 
-    blockTracking = false;
-    q_ptr->setLowerValue(lowerPos);
-    q_ptr->setUpperValue(upperPos);
+QxtSpanSliderPrivate::OverlayKey QxtSpanSliderPrivate::currentOverlayKey() const
+{
+    int sliderMin = 0;
+    int sliderMax = 0;
+    int sliderLength = 0;
+    bool upsideDown = false;
+    sliderGeometry(&sliderMin, &sliderMax, &sliderLength, &upsideDown);
+
+    // 主轴覆盖滑块柄中心可到达的区间，交叉轴覆盖整个部件
+    const QxtSpanSlider* p = q_ptr;
+    const int first = sliderMin + sliderLength / 2;
+    const int last = sliderMax + sliderLength / 2;
+    OverlayKey key;
+    if (p->orientation() == Qt::Horizontal)
+        key.rect = QRect(QPoint(first, 0), QPoint(last, p->height() - 1));
+    else
+        key.rect = QRect(QPoint(0, first), QPoint(p->width() - 1, last));
+    key.minimum = p->minimum();
+    key.maximum = p->maximum();
+    key.orientation = p->orientation();
+    key.upsideDown = upsideDown;
+    return key;
 }
 
-void QxtSpanSliderPrivate::swapControls()
+void QxtSpanSliderPrivate::cancelOverlay()
 {
-    qSwap(lower, upper);
-    qSwap(lowerPressed, upperPressed);
-    lastPressed = (lastPressed == QxtSpanSlider::LowerHandle ? QxtSpanSlider::UpperHandle : QxtSpanSlider::LowerHandle);
-    mainControl = (mainControl == QxtSpanSlider::LowerHandle ? QxtSpanSlider::UpperHandle : QxtSpanSlider::LowerHandle);
+    overlayGeneration.ref();
+    if (overlayPool)
+    {
+        overlayPool->clear();
+        overlayPool->waitForDone();
+    }
+}
+
+void QxtSpanSliderPrivate::drawOverlay(QPainter* painter)
+{
+    if (!overlay)
+        return;
+
+    QXT_SPANSLIDER_TRACE_SCOPE("paintEvent/overlay");
+    const OverlayKey key = currentOverlayKey();
+    if (!(key == overlayKey))
+        scheduleOverlay();
+
+    // 新图像完成前继续显示上一幅图像（必要时缩放）
+    if (!overlayImage.isNull())
+        painter->drawImage(key.rect, overlayImage);
+}
+
+void QxtSpanSliderPrivate::scheduleOverlay()
+{
+    // 增加代数即可取消所有正在进行的渲染
+    overlayGeneration.ref();
+    if (!overlayScheduled)
+    {
+        overlayScheduled = true;
+        QMetaObject::invokeMethod(this, "startOverlayRender", Qt::QueuedConnection);
+    }
+}
+
+void QxtSpanSliderPrivate::startOverlayRender()
+{
+    overlayScheduled = false;
+    overlayKey = currentOverlayKey();
+    if (!overlay || overlayKey.rect.isEmpty())
+        return;
+
+    if (!overlayPool)
+    {
+        // 每个滑块使用一个工作线程，过时的渲染任务在开始前就会被丢弃
+        overlayPool = new QThreadPool(this);
+        overlayPool->setMaxThreadCount(1);
+    }
+    overlayPool->clear();
+
+    QxtSpanSliderOverlayJob* job = new QxtSpanSliderOverlayJob(overlay, this, &overlayGeneration);
+    job->size = overlayKey.rect.size();
+    job->minimum = overlayKey.minimum;
+    job->maximum = overlayKey.maximum;
+    job->orientation = overlayKey.orientation;
+    job->upsideDown = overlayKey.upsideDown;
+    overlayPool->start(job);
+}
+
+void QxtSpanSliderPrivate::overlayRendered(const QImage& image, int generation)
+{
+    if (generation != overlayGeneration.load())
+        return;
+    overlayImage = image;
+    q_ptr->update(overlayKey.rect);
 }
 
 void QxtSpanSliderPrivate::updateRange(int min, int max)
 {
     Q_UNUSED(min);
     Q_UNUSED(max);
+    invalidateLabels();
+    // 事务中由 commitUpdate() 统一校验
+    if (updateDepth > 0)
+    {
+        rangeStaged = true;
+        return;
+    }
     // setSpan() takes care of keeping span in range
     q_ptr->setSpan(lower, upper);
 }
 
+void QxtSpanSliderPrivate::updateQuantileSpan()
+{
+    if (quantileMode && !sketch.isEmpty())
+        emit q_ptr->quantileSpanChanged(q_ptr->lowerQuantileValue(), q_ptr->upperQuantileValue());
+}
+
 void QxtSpanSliderPrivate::movePressedHandle()
 {
     switch (lastPressed)
@@ -378,6 +831,18 @@ void QxtSpanSliderPrivate::movePressedHandle()
     每当按下 \a handle 时，都会发出此信号。
  */
 
+/*!
+    \fn QxtSpanSlider::quantileSpanChanged(double lower, double upper)
+    分位数模式下跨度或草图变化时发出此信号，\a lower 和 \a upper 是两个滑块柄的分位数对应的数据值。
+ */
+
+/*!
+    \fn QxtSpanSlider::prefetchRequested(int lower, int upper)
+    拖动中预测的跨度离开已预取的窗口时发出此信号，\a lower 到 \a upper 是建议预取的新窗口。
+
+    \sa prefetchHorizon, predictedSpan()
+ */
+
 /*!
     使用 \a parent 构造一个新的 QxtSpanSlider。
  */
@@ -386,6 +851,7 @@ QxtSpanSlider::QxtSpanSlider(QWidget* parent) : QSlider(parent), d_ptr(new QxtSp
     d_ptr->q_ptr = this;
     connect(this, SIGNAL(rangeChanged(int, int)), d_ptr, SLOT(updateRange(int, int)));
     connect(this, SIGNAL(sliderReleased()), d_ptr, SLOT(movePressedHandle()));
+    connect(this, SIGNAL(spanChanged(int, int)), d_ptr, SLOT(updateQuantileSpan()));
 }
 /*!
     使用 \a orientation 和 \a parent 构造一个新的 QxtSpanSlider。
@@ -395,81 +861,302 @@ QxtSpanSlider::QxtSpanSlider(Qt::Orientation orientation, QWidget* parent) : QSl
     d_ptr->q_ptr = this;
     connect(this, SIGNAL(rangeChanged(int, int)), d_ptr, SLOT(updateRange(int, int)));
     connect(this, SIGNAL(sliderReleased()), d_ptr, SLOT(movePressedHandle()));
+    connect(this, SIGNAL(spanChanged(int, int)), d_ptr, SLOT(updateQuantileSpan()));
+}
+
+/*!
+    销毁 QxtSpanSlider 对象。
+ */
+QxtSpanSlider::~QxtSpanSlider()
+{
+    delete d_ptr;
+}
+
+/*!
+    \property QxtSpanSlider::handleMovementMode
+    \brief 滑块移动模式
+ */
+QxtSpanSlider::HandleMovementMode QxtSpanSlider::handleMovementMode() const
+{
+    return d_ptr->movement;
+}
+
+void QxtSpanSlider::setHandleMovementMode(QxtSpanSlider::HandleMovementMode mode)
+{
+    if (d_ptr->updateDepth > 0 && d_ptr->movement != mode)
+        d_ptr->rangeStaged = true;
+    d_ptr->movement = mode;
+}
+
+/*!
+    \property QxtSpanSlider::lowerValue
+    \brief 范围的下限值
+ */
+int QxtSpanSlider::lowerValue() const
+{
+    return qMin(d_ptr->lower, d_ptr->upper);
+}
+
+void QxtSpanSlider::setLowerValue(int lower)
+{
+    setSpan(lower, d_ptr->spanStaged ? d_ptr->stagedUpper : d_ptr->upper);
+}
+
+/*!
+    \property QxtSpanSlider::upperValue
+    \brief 范围的上限值
+ */
+int QxtSpanSlider::upperValue() const
+{
+    return qMax(d_ptr->lower, d_ptr->upper);
+}
+
+void QxtSpanSlider::setUpperValue(int upper)
+{
+    setSpan(d_ptr->spanStaged ? d_ptr->stagedLower : d_ptr->lower, upper);
+}
+
+/*!
+    设置范围，从 \a lower 到 \a upper。
+    在批量更新事务中，新的范围只被暂存，直到 commitUpdate() 时才生效。
+ */
+void QxtSpanSlider::setSpan(int lower, int upper)
+{
+    QXT_SPANSLIDER_TRACE_SCOPE("setSpan");
+    if (d_ptr->updateDepth > 0)
+    {
+        d_ptr->spanStaged = true;
+        d_ptr->stagedLower = lower;
+        d_ptr->stagedUpper = upper;
+        return;
+    }
+
+    const int low = qBound(minimum(), qMin(lower, upper), maximum());
+    const int upp = qBound(minimum(), qMax(lower, upper), maximum());
+    if (low != d_ptr->lower || upp != d_ptr->upper)
+    {
+        if (low != d_ptr->lower)
+        {
+            d_ptr->lower = low;
+            d_ptr->lowerPos = low;
+            QXT_SPANSLIDER_TRACE_SCOPE("emit lowerValueChanged");
+            emit lowerValueChanged(low);
+        }
+        if (upp != d_ptr->upper)
+        {
+            d_ptr->upper = upp;
+            d_ptr->upperPos = upp;
+            QXT_SPANSLIDER_TRACE_SCOPE("emit upperValueChanged");
+            emit upperValueChanged(upp);
+        }
+        {
+            QXT_SPANSLIDER_TRACE_SCOPE("emit spanChanged");
+            emit spanChanged(d_ptr->lower, d_ptr->upper);
+        }
+        update();
+    }
+}
+
+/*!
+    保持跨度宽度不变，把跨度平移到以 \a lower 为下限的位置。
+
+    跨度被限制在范围之内：平移超出最小值或最大值时停在边界上，宽度始终保持不变。
+    与先后调用 setLowerValue() 和 setUpperValue() 不同，两个滑块一次性移动，
+    只发出一次 spanChanged() 并只重绘一次，也不会在 NoOverlapping 模式下被中间状态错误地限制。
+    拖动两个滑块柄之间的跨度时使用的也是这个函数。
+
+    \sa setSpan()
+ */
+void QxtSpanSlider::moveSpan(int lower)
+{
+    const int low = d_ptr->spanStaged ? d_ptr->stagedLower : d_ptr->lower;
+    const int upp = d_ptr->spanStaged ? d_ptr->stagedUpper : d_ptr->upper;
+    const qint64 width = qAbs(qint64(upp) - low);
+    if (width > qint64(maximum()) - minimum())
+        return;
+
+    const int newLower = int(qBound(qint64(minimum()), qint64(lower), qint64(maximum()) - width));
+    setSpan(newLower, int(newLower + width));
+}
+
+/*!
+    \property QxtSpanSlider::quantileMode
+    \brief 是否使用分位数模式
+
+    在分位数模式下，滑块的位置表示分位数：minimum() 对应第 0 分位（最小值），maximum() 对应第 1 分位（最大值），
+    中间线性插值。lowerValue() 和 upperValue() 仍然是滑块的位置，对应的数据值由 quantileSketch() 解析，
+    通过 lowerQuantileValue()、upperQuantileValue() 和 quantileSpanChanged() 获得。
+    未设置 valueFormatter() 时，刻度标签和滑块读数显示解析后的数据值。
+    范围越大，分位数的分辨率越高，例如范围 0 到 1000 对应千分位。默认值为 false。
+
+    \sa setQuantileSpan()
+ */
+bool QxtSpanSlider::isQuantileMode() const
+{
+    return d_ptr->quantileMode;
+}
+
+void QxtSpanSlider::setQuantileMode(bool enabled)
+{
+    if (d_ptr->quantileMode != enabled)
+    {
+        d_ptr->quantileMode = enabled;
+        d_ptr->invalidateLabels();
+        updateGeometry();
+        update();
+        d_ptr->updateQuantileSpan();
+    }
+}
+
+/*!
+    返回分位数模式使用的草图的副本。
+ */
+QxtQuantileSketch QxtSpanSlider::quantileSketch() const
+{
+    return d_ptr->sketch;
+}
+
+/*!
+    把分位数模式使用的草图设置为 \a sketch 的副本。
+
+    草图占用的内存有上限，复制的开销很小。数据源可以在自己的线程中持续更新草图或合并各线程的草图，
+    然后在 GUI 线程中调用此函数刷新滑块；滑块的位置保持不变，解析出的数据值随之更新并发出 quantileSpanChanged()。
+ */
+void QxtSpanSlider::setQuantileSketch(const QxtQuantileSketch& sketch)
+{
+    d_ptr->sketch = sketch;
+    if (d_ptr->quantileMode)
+    {
+        d_ptr->invalidateLabels();
+        update();
+        d_ptr->updateQuantileSpan();
+    }
+}
+
+/*!
+    返回下限滑块柄对应的分位数，在 0 到 1 之间。
+ */
+qreal QxtSpanSlider::lowerQuantile() const
+{
+    return d_ptr->valueToQuantile(lowerValue());
+}
+
+/*!
+    返回上限滑块柄对应的分位数，在 0 到 1 之间。
+ */
+qreal QxtSpanSlider::upperQuantile() const
+{
+    return d_ptr->valueToQuantile(upperValue());
+}
+
+/*!
+    返回下限滑块柄所在分位数对应的数据值。草图为空时返回 0。
+ */
+double QxtSpanSlider::lowerQuantileValue() const
+{
+    return d_ptr->sketch.quantile(lowerQuantile());
 }
 
 /*!
-    销毁 QxtSpanSlider 对象。
+    返回上限滑块柄所在分位数对应的数据值。草图为空时返回 0。
  */
-QxtSpanSlider::~QxtSpanSlider()
+double QxtSpanSlider::upperQuantileValue() const
 {
+    return d_ptr->sketch.quantile(upperQuantile());
 }
 
 /*!
-    \property QxtSpanSlider::handleMovementMode
-    \brief 滑块移动模式
+    把跨度设置为从第 \a lower 分位到第 \a upper 分位，两者都被限制在 0 到 1 之间。
+    例如 setQuantileSpan(0.05, 0.95) 选中中间的 90% 数据，而不需要对数据排序。
+
+    \sa quantileMode
  */
-QxtSpanSlider::HandleMovementMode QxtSpanSlider::handleMovementMode() const
+void QxtSpanSlider::setQuantileSpan(qreal lower, qreal upper)
 {
-    return d_ptr->movement;
+    const qreal span = qreal(maximum()) - minimum();
+    setSpan(int(minimum() + qRound64(qBound<qreal>(0, lower, 1) * span)),
+            int(minimum() + qRound64(qBound<qreal>(0, upper, 1) * span)));
 }
 
-void QxtSpanSlider::setHandleMovementMode(QxtSpanSlider::HandleMovementMode mode)
+/*!
+    返回下限滑块柄的拖动速度，单位为值/秒。
+
+    速度和加速度由 alpha-beta-gamma 滤波器从 mouseMoveEvent() 的位置采样中估计。
+    没有拖动、或者超过 100 毫秒没有新的移动事件时返回 0。
+
+    \sa upperVelocity(), lowerAcceleration(), predictedSpan()
+ */
+qreal QxtSpanSlider::lowerVelocity() const
 {
-    d_ptr->movement = mode;
+    return d_ptr->motion.lowerVelocity();
 }
 
 /*!
-    \property QxtSpanSlider::lowerValue
-    \brief 范围的下限值
+    返回上限滑块柄的拖动速度，单位为值/秒。
+
+    \sa lowerVelocity()
  */
-int QxtSpanSlider::lowerValue() const
+qreal QxtSpanSlider::upperVelocity() const
 {
-    return qMin(d_ptr->lower, d_ptr->upper);
+    return d_ptr->motion.upperVelocity();
 }
 
-void QxtSpanSlider::setLowerValue(int lower)
+/*!
+    返回下限滑块柄的拖动加速度，单位为值/秒²。
+
+    \sa lowerVelocity()
+ */
+qreal QxtSpanSlider::lowerAcceleration() const
 {
-    setSpan(lower, d_ptr->upper);
+    return d_ptr->motion.lowerAcceleration();
 }
 
 /*!
-    \property QxtSpanSlider::upperValue
-    \brief 范围的上限值
+    返回上限滑块柄的拖动加速度，单位为值/秒²。
+
+    \sa lowerVelocity()
  */
-int QxtSpanSlider::upperValue() const
+qreal QxtSpanSlider::upperAcceleration() const
 {
-    return qMax(d_ptr->lower, d_ptr->upper);
+    return d_ptr->motion.upperAcceleration();
 }
 
-void QxtSpanSlider::setUpperValue(int upper)
+/*!
+    返回按当前速度和加速度外推 \a msecs 毫秒之后的跨度，first 为下限，second 为上限。
+
+    结果被限制在范围之内。没有拖动或拖动已停顿时返回滑块柄的当前位置。
+ */
+QPair<int, int> QxtSpanSlider::predictedSpan(int msecs) const
 {
-    setSpan(d_ptr->lower, upper);
+    qint64 low = d_ptr->lowerPos;
+    qint64 upp = d_ptr->upperPos;
+    if (d_ptr->motion.isActive())
+    {
+        low = qRound64(d_ptr->motion.predictLower(msecs));
+        upp = qRound64(d_ptr->motion.predictUpper(msecs));
+    }
+    low = qBound(qint64(minimum()), low, qint64(maximum()));
+    upp = qBound(qint64(minimum()), upp, qint64(maximum()));
+    return qMakePair(int(qMin(low, upp)), int(qMax(low, upp)));
 }
 
 /*!
-    设置范围，从 \a lower 到 \a upper。
+    \property QxtSpanSlider::prefetchHorizon
+    \brief 预取的预测时间，单位为毫秒
+
+    拖动时，每个移动事件都会计算 predictedSpan(prefetchHorizon)。如果预测的跨度离开了上一次请求的窗口，
+    就发出 prefetchRequested()，新窗口覆盖当前跨度和预测跨度，并在两端各留出半个跨度宽度。
+    每次按下鼠标都会重新开始。为 0 时不发出该信号。默认值为 200。
  */
-void QxtSpanSlider::setSpan(int lower, int upper)
+int QxtSpanSlider::prefetchHorizon() const
 {
-    const int low = qBound(minimum(), qMin(lower, upper), maximum());
-    const int upp = qBound(minimum(), qMax(lower, upper), maximum());
-    if (low != d_ptr->lower || upp != d_ptr->upper)
-    {
-        if (low != d_ptr->lower)
-        {
-            d_ptr->lower = low;
-            d_ptr->lowerPos = low;
-            emit lowerValueChanged(low);
-        }
-        if (upp != d_ptr->upper)
-        {
-            d_ptr->upper = upp;
-            d_ptr->upperPos = upp;
-            emit upperValueChanged(upp);
-        }
-        emit spanChanged(d_ptr->lower, d_ptr->upper);
-        update();
-    }
+    return d_ptr->prefetchHorizon;
+}
+
+void QxtSpanSlider::setPrefetchHorizon(int msecs)
+{
+    d_ptr->prefetchHorizon = qMax(msecs, 0);
+    d_ptr->prefetchValid = false;
 }
 
 /*!
@@ -540,6 +1227,353 @@ void QxtSpanSlider::setUpperPosition(int upper)
     }
 }
 
+/*!
+    \property QxtSpanSlider::tickLabelsVisible
+    \brief 是否在刻度位置绘制数值标签
+
+    标签使用 valueFormatter() 格式化，并以 QStaticText 缓存。标签布局只在尺寸、范围或刻度间隔变化时重新计算。
+    水平方向时标签绘制在滑块下方，垂直方向时绘制在右侧。默认值为 false。
+ */
+bool QxtSpanSlider::tickLabelsVisible() const
+{
+    return d_ptr->tickLabelsVisible;
+}
+
+void QxtSpanSlider::setTickLabelsVisible(bool visible)
+{
+    if (d_ptr->tickLabelsVisible != visible)
+    {
+        d_ptr->tickLabelsVisible = visible;
+        d_ptr->invalidateLabels();
+        updateGeometry();
+        update();
+    }
+}
+
+/*!
+    \property QxtSpanSlider::valueReadoutsVisible
+    \brief 是否在两个滑块旁绘制当前数值
+
+    水平方向时读数绘制在滑块上方，垂直方向时绘制在左侧。拖动时只重新生成这两个读数的文本。默认值为 false。
+ */
+bool QxtSpanSlider::valueReadoutsVisible() const
+{
+    return d_ptr->valueReadoutsVisible;
+}
+
+void QxtSpanSlider::setValueReadoutsVisible(bool visible)
+{
+    if (d_ptr->valueReadoutsVisible != visible)
+    {
+        d_ptr->valueReadoutsVisible = visible;
+        updateGeometry();
+        update();
+    }
+}
+
+/*!
+    \property QxtSpanSlider::timeAxis
+    \brief 是否使用时间轴模式
+
+    在时间轴模式下，滑块的值被视为 Unix 时间（秒，本地时区）。刻度和刻度标签不再使用固定的 tickInterval，
+    而是从秒、分钟、小时、天、周、月和年的日历步长中选择能在当前像素长度内放下的最小步长，并与日历边界对齐。
+    刻度布局按宽度和范围缓存，范围平移时只补充两端新出现的刻度；paintEvent() 只绘制预先计算好的位置，
+    从不遍历原始范围。未设置 valueFormatter() 时，滑块读数显示完整的日期和时间。默认值为 false。
+ */
+bool QxtSpanSlider::isTimeAxis() const
+{
+    return d_ptr->timeAxis;
+}
+
+void QxtSpanSlider::setTimeAxis(bool enabled)
+{
+    if (d_ptr->timeAxis != enabled)
+    {
+        d_ptr->timeAxis = enabled;
+        d_ptr->timeTicks.invalidate();
+        d_ptr->invalidateLabels();
+        updateGeometry();
+        update();
+    }
+}
+
+/*!
+    返回刻度标签和滑块读数使用的格式化函数。未设置时返回空函数，数值按 QString::number() 显示。
+ */
+QxtSpanSlider::ValueFormatter QxtSpanSlider::valueFormatter() const
+{
+    return d_ptr->formatter;
+}
+
+/*!
+    设置刻度标签和滑块读数使用的格式化函数 \a formatter。
+ */
+void QxtSpanSlider::setValueFormatter(const ValueFormatter& formatter)
+{
+    d_ptr->formatter = formatter;
+    d_ptr->textCache.clear();
+    d_ptr->invalidateLabels();
+    updateGeometry();
+    update();
+}
+
+/*!
+    开始一个批量更新事务。
+
+    恢复保存的视图通常需要依次调用 setMinimum()、setMaximum()、setHandleMovementMode() 和 setSpan()。
+    在事务之外，每次范围变化都会经过 setSpan() 各自发出信号并重绘，使用者会看到若干个中间状态。
+    在事务之内，范围变化不再调整跨度，setSpan()、setLowerValue() 和 setUpperValue() 只暂存新的跨度；
+    lowerValue() 和 upperValue() 在提交之前仍返回事务开始前的值。
+
+    \bold {注意:} rangeChanged() 由 QAbstractSlider 在 setMinimum()、setMaximum() 和 setRange() 中直接发出，
+    无法推迟，事务中的每次范围变化仍会立即发出 rangeChanged()。被推迟的是跨度按新范围的校验，
+    以及 spanChanged()、lowerValueChanged() 和 upperValueChanged()。
+
+    事务可以嵌套，只有最外层的 commitUpdate() 才会提交。通常使用 QxtSpanSliderUpdateGuard：
+    \code
+    {
+        QxtSpanSliderUpdateGuard guard(slider);
+        slider->setRange(view.minimum, view.maximum);
+        slider->setHandleMovementMode(view.mode);
+        slider->setSpan(view.lower, view.upper);
+    } // 最多发出一次 spanChanged()
+    \endcode
+ */
+void QxtSpanSlider::beginUpdate()
+{
+    ++d_ptr->updateDepth;
+}
+
+/*!
+    提交批量更新事务。
+
+    暂存的跨度（没有暂存时为当前跨度）按最终的范围和滑块移动模式校验一次，
+    然后最多发出一次 spanChanged()，以及真正发生变化的 lowerValueChanged() 和 upperValueChanged()。
+    只有跨度、范围或滑块移动模式在事务中发生了变化时才安排一次重绘，空的事务不会重绘。
+ */
+void QxtSpanSlider::commitUpdate()
+{
+    if (d_ptr->updateDepth <= 0)
+    {
+        qWarning("QxtSpanSlider::commitUpdate: No update in progress");
+        return;
+    }
+    if (--d_ptr->updateDepth > 0)
+        return;
+
+    QXT_SPANSLIDER_TRACE_SCOPE("commitUpdate");
+    const int lower = d_ptr->spanStaged ? d_ptr->stagedLower : d_ptr->lower;
+    const int upper = d_ptr->spanStaged ? d_ptr->stagedUpper : d_ptr->upper;
+    const bool rangeStaged = d_ptr->rangeStaged;
+    d_ptr->spanStaged = false;
+    d_ptr->rangeStaged = false;
+
+    int low = qBound(minimum(), qMin(lower, upper), maximum());
+    int upp = qBound(minimum(), qMax(lower, upper), maximum());
+    if (d_ptr->movement == NoOverlapping && low == upp && minimum() < maximum())
+    {
+        if (upp < maximum())
+            ++upp;
+        else
+            --low;
+    }
+
+    // setSpan() 在跨度变化时自行重绘；跨度不变时只有范围或模式的变化需要重绘
+    setSpan(low, upp);
+    if (rangeStaged)
+        update();
+}
+
+/*!
+    如果正在进行批量更新事务，则返回 true。
+ */
+bool QxtSpanSlider::isUpdating() const
+{
+    return d_ptr->updateDepth > 0;
+}
+
+/*!
+    返回当前的叠加层，未设置时返回 0。
+ */
+QxtSpanSliderOverlay* QxtSpanSlider::overlay() const
+{
+    return d_ptr->overlay;
+}
+
+/*!
+    设置绘制在滑槽和跨度后方的叠加层 \a overlay。滑块不获得叠加层的所有权。
+
+    叠加层在工作线程中渲染，先显示粗略的一遍，再逐遍细化。尺寸、范围变化或叠加层发出
+    QxtSpanSliderOverlay::changed() 时，过时的渲染会被取消；paintEvent() 只绘制最近一次完成的图像。
+    替换叠加层时会等待正在进行的渲染结束。
+ */
+void QxtSpanSlider::setOverlay(QxtSpanSliderOverlay* overlay)
+{
+    if (d_ptr->overlay == overlay)
+        return;
+
+    if (d_ptr->overlay)
+        disconnect(d_ptr->overlay, SIGNAL(changed()), d_ptr, SLOT(scheduleOverlay()));
+    d_ptr->cancelOverlay();
+    d_ptr->overlayImage = QImage();
+    d_ptr->overlay = overlay;
+    if (overlay)
+    {
+        connect(overlay, SIGNAL(changed()), d_ptr, SLOT(scheduleOverlay()));
+        d_ptr->scheduleOverlay();
+    }
+    update();
+}
+
+/*!
+    \class QxtSpanSliderRenderOptions
+    \inmodule QxtWidgets
+    \brief QxtSpanSliderRenderOptions 描述 QxtSpanSlider::renderImage() 渲染的一个滑块状态。
+
+    范围、方向和刻度的默认值与新建的水平 QxtSpanSlider 相同：范围为 0 到 99，没有刻度。
+    跨度默认覆盖整个范围 [0, 99]，而新建的滑块的跨度为 [0, 0]；图像尺寸默认为 160x22。
+ */
+
+/*!
+    构造默认的渲染选项。
+ */
+QxtSpanSliderRenderOptions::QxtSpanSliderRenderOptions() :
+        minimum(0),
+        maximum(99),
+        lower(0),
+        upper(99),
+        orientation(Qt::Horizontal),
+        size(160, 22),
+        tickPosition(QSlider::NoTicks),
+        tickInterval(0),
+        pageStep(10),
+        invertedAppearance(false),
+        style(0)
+{
+}
+
+/*!
+    不创建任何部件，把 \a options 描述的滑块状态渲染为一幅 QImage。
+
+    滑槽、刻度、跨度和两个滑块的绘制代码与 paintEvent() 完全相同，使用光栅绘制引擎。
+    图像背景以调色板的 QPalette::Window 颜色填充。叠加层、刻度标签和读数不会被渲染。
+ */
+QImage QxtSpanSlider::renderImage(const QxtSpanSliderRenderOptions& options)
+{
+    QStyle* style = options.style ? options.style : QApplication::style();
+    const bool horizontal = (options.orientation == Qt::Horizontal);
+    const int minimum = qMin(options.minimum, options.maximum);
+    const int maximum = qMax(options.minimum, options.maximum);
+
+    QStyleOptionSlider opt;
+    opt.rect = QRect(QPoint(0, 0), options.size);
+    opt.palette = options.palette;
+    opt.direction = Qt::LeftToRight;
+    opt.state = QStyle::State_Enabled;
+    if (horizontal)
+        opt.state |= QStyle::State_Horizontal;
+    opt.subControls = QStyle::SC_None;
+    opt.activeSubControls = QStyle::SC_None;
+    opt.orientation = options.orientation;
+    opt.minimum = minimum;
+    opt.maximum = maximum;
+    opt.tickPosition = options.tickPosition;
+    opt.tickInterval = options.tickInterval;
+    opt.singleStep = 1;
+    opt.pageStep = options.pageStep;
+    opt.upsideDown = horizontal ? options.invertedAppearance : !options.invertedAppearance;
+
+    QxtSpanSliderPrivate::PaintState state;
+    state.lower = qBound(minimum, qMin(options.lower, options.upper), maximum);
+    state.upper = qBound(minimum, qMax(options.lower, options.upper), maximum);
+    state.lowerPos = state.lower;
+    state.upperPos = state.upper;
+    state.lowerPressed = QStyle::SC_None;
+    state.upperPressed = QStyle::SC_None;
+    state.lastPressed = QxtSpanSlider::NoHandle;
+    opt.sliderPosition = state.upper;
+    opt.sliderValue = state.upper;
+
+    QImage image(options.size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(options.palette.color(QPalette::Window));
+    QPainter painter(&image);
+    QxtSpanSliderPrivate::paintSlider(&painter, style, opt, state, 0);
+    return image;
+}
+
+/*!
+    在线程池 \a pool（为 0 时使用 QThreadPool::globalInstance()）中并行渲染 \a options 中的每个滑块状态，
+    按相同的顺序返回图像。函数会阻塞直到所有图像渲染完成。
+
+    默认样式在调用线程中解析，工作线程不访问 QApplication。
+    调用线程本身也参与渲染，并且只把任务交给 \a pool 中当时空闲的线程（QThreadPool::tryStart()），
+    因此即使在 \a pool 的工作线程中调用、或者 \a pool 已经饱和，也不会因为等待永远不会开始的任务而死锁；
+    没有空闲线程时所有图像都在调用线程中渲染。
+    \bold {注意:} 并行渲染要求样式在非 GUI 线程中绘制是安全的，并且平台支持在非 GUI 线程中使用 QPixmap
+    （光栅平台通常满足）。否则请传入只有一个线程的线程池，或者逐个调用 renderImage()。
+ */
+QVector<QImage> QxtSpanSlider::renderImages(const QVector<QxtSpanSliderRenderOptions>& options, QThreadPool* pool)
+{
+    QVector<QImage> images(options.size());
+    if (options.isEmpty())
+        return images;
+    if (!pool)
+        pool = QThreadPool::globalInstance();
+
+    // 每次领取一小批图像，减少调度开销
+    RenderBatches batches;
+    batches.options = options.constData();
+    batches.images = images.data();
+    batches.count = options.size();
+    batches.style = QApplication::style();
+
+    const int helpers = qMin(pool->maxThreadCount(), (options.size() - 1) / RenderBatches::BatchSize);
+    QSemaphore done;
+    int started = 0;
+    for (int i = 0; i < helpers; ++i)
+    {
+        RenderTask* task = new RenderTask(&batches, &done);
+        if (!pool->tryStart(task))
+        {
+            delete task;
+            break;
+        }
+        ++started;
+    }
+    batches.renderAll();
+    done.acquire(started);
+    return images;
+}
+
+/*!
+    \reimp
+    在 QSlider 的尺寸基础上为可见的标签和读数预留空间。
+ */
+QSize QxtSpanSlider::sizeHint() const
+{
+    QSize hint = QSlider::sizeHint();
+    const int strips = (d_ptr->tickLabelsVisible ? 1 : 0) + (d_ptr->valueReadoutsVisible ? 1 : 0);
+    if (orientation() == Qt::Horizontal)
+        hint.rheight() += strips * d_ptr->labelStripHeight();
+    else
+        hint.rwidth() += strips * d_ptr->labelStripWidth();
+    return hint;
+}
+
+/*!
+    \reimp
+ */
+QSize QxtSpanSlider::minimumSizeHint() const
+{
+    QSize hint = QSlider::minimumSizeHint();
+    const int strips = (d_ptr->tickLabelsVisible ? 1 : 0) + (d_ptr->valueReadoutsVisible ? 1 : 0);
+    if (orientation() == Qt::Horizontal)
+        hint.rheight() += strips * d_ptr->labelStripHeight();
+    else
+        hint.rwidth() += strips * d_ptr->labelStripWidth();
+    return hint;
+}
+
 /*!
     \reimp
     处理键盘按键事件，用于改变滑块的位置。
@@ -593,6 +1627,7 @@ void QxtSpanSlider::keyPressEvent(QKeyEvent* event)
     处理鼠标按下事件。
 
     此方法用于处理滑块的鼠标按下操作，并确定用户按下的是哪个滑块（上限或下限滑块）。
+    如果没有按在滑块柄上而是按在两个滑块柄之间的跨度上，则开始拖动整个跨度。
     如果两个滑块之间的距离等于最小值或最大值，或者鼠标按键未正确释放，则忽略该事件。
 
     \param event 指向鼠标事件对象的指针。
@@ -609,6 +1644,26 @@ void QxtSpanSlider::mousePressEvent(QMouseEvent* event)
     if (d_ptr->upperPressed != QStyle::SC_SliderHandle)
         d_ptr->handleMousePress(event->pos(), d_ptr->lowerPressed, d_ptr->lower, QxtSpanSlider::LowerHandle);
 
+    // 按在跨度上：记录按下时的值，之后按相对位移平移整个跨度
+    if (d_ptr->lowerPressed != QStyle::SC_SliderHandle && d_ptr->upperPressed != QStyle::SC_SliderHandle
+        && d_ptr->lower != d_ptr->upper && d_ptr->hitSpan(event->pos()))
+    {
+        int sliderMin = 0;
+        int sliderMax = 0;
+        int sliderLength = 0;
+        bool upsideDown = false;
+        d_ptr->sliderGeometry(&sliderMin, &sliderMax, &sliderLength, &upsideDown);
+        d_ptr->offset = sliderLength / 2;
+        d_ptr->spanPressed = true;
+        d_ptr->spanPressValue = d_ptr->pixelPosToRangeValue(d_ptr->pick(event->pos()) - d_ptr->offset);
+        d_ptr->spanPressLower = lowerValue();
+        setSliderDown(true);
+    }
+
+    // 每次按下都重新开始速度估计和预取窗口
+    d_ptr->motion.reset();
+    d_ptr->prefetchValid = false;
+
     d_ptr->firstMovement = true;
     event->accept();
 }
@@ -620,16 +1675,39 @@ void QxtSpanSlider::mousePressEvent(QMouseEvent* event)
     在滑块被按住且移动时，该方法会根据鼠标的位置更新滑块的位置。
     如果移动距离超过指定范围，滑块将不会被更新。
     在自由移动模式下，如果新的滑块位置跨越了另一滑块的位置，两个滑块的控制会被交换。
+    拖动跨度时，两个滑块按鼠标的相对位移一起平移，每一步只通过 moveSpan() 更新一次。
 
     \param event 指向鼠标事件对象的指针。
  */
 void QxtSpanSlider::mouseMoveEvent(QMouseEvent* event)
 {
+    if (d_ptr->spanPressed)
+    {
+        QXT_SPANSLIDER_TRACE_SCOPE("mouseMoveEvent/span");
+        QStyleOptionSlider opt;
+        d_ptr->initStyleOption(&opt);
+        const int m = style()->pixelMetric(QStyle::PM_MaximumDragDistance, &opt, this);
+        int newLower = d_ptr->spanPressLower;
+        if (m < 0 || rect().adjusted(-m, -m, m, m).contains(event->pos()))
+        {
+            const int value = d_ptr->pixelPosToRangeValue(d_ptr->pick(event->pos()) - d_ptr->offset);
+            newLower = int(qBound(qint64(minimum()), qint64(d_ptr->spanPressLower) + value - d_ptr->spanPressValue, qint64(maximum())));
+        }
+        moveSpan(newLower);
+        {
+            QXT_SPANSLIDER_TRACE_SCOPE("mouseMoveEvent/trackMotion");
+            d_ptr->trackMotion(event->timestamp());
+        }
+        event->accept();
+        return;
+    }
+
     if (d_ptr->lowerPressed != QStyle::SC_SliderHandle && d_ptr->upperPressed != QStyle::SC_SliderHandle)
     {
         event->ignore();
         return;
     }
+    QXT_SPANSLIDER_TRACE_SCOPE("mouseMoveEvent");
 
     QStyleOptionSlider opt;
     d_ptr->initStyleOption(&opt);
@@ -645,55 +1723,36 @@ void QxtSpanSlider::mouseMoveEvent(QMouseEvent* event)
     }
 
     // 在第一次移动时，选择优先操作的滑块
-    if (d_ptr->firstMovement)
     {
-        if (d_ptr->lower == d_ptr->upper)
+        QXT_SPANSLIDER_TRACE_SCOPE("mouseMoveEvent/clampSwap");
+        if (d_ptr->firstMovement)
         {
-            if (newPosition < lowerValue())
+            if (d_ptr->lower == d_ptr->upper)
+            {
+                if (newPosition < lowerValue())
+                {
+                    d_ptr->swapControls();
+                    d_ptr->firstMovement = false;
+                }
+            }
+            else
             {
-                d_ptr->swapControls();
                 d_ptr->firstMovement = false;
             }
         }
-        else
-        {
-            d_ptr->firstMovement = false;
-        }
     }
 
-    if (d_ptr->lowerPressed == QStyle::SC_SliderHandle)
     {
-        if (d_ptr->movement == NoCrossing)
-            newPosition = qMin(newPosition, upperValue());
-        else if (d_ptr->movement == NoOverlapping)
-            newPosition = qMin(newPosition, upperValue() - 1);
-
-        if (d_ptr->movement == FreeMovement && newPosition > d_ptr->upper)
-        {
-            d_ptr->swapControls();
-            setUpperPosition(newPosition);
-        }
-        else
-        {
-            setLowerPosition(newPosition);
-        }
+        QXT_SPANSLIDER_TRACE_SCOPE("mouseMoveEvent/moveHandle");
+        if (d_ptr->lowerPressed == QStyle::SC_SliderHandle)
+            d_ptr->moveHandle(false, newPosition, lowerValue(), upperValue());
+        else if (d_ptr->upperPressed == QStyle::SC_SliderHandle)
+            d_ptr->moveHandle(true, newPosition, lowerValue(), upperValue());
     }
-    else if (d_ptr->upperPressed == QStyle::SC_SliderHandle)
-    {
-        if (d_ptr->movement == NoCrossing)
-            newPosition = qMax(newPosition, lowerValue());
-        else if (d_ptr->movement == NoOverlapping)
-            newPosition = qMax(newPosition, lowerValue() + 1);
 
-        if (d_ptr->movement == FreeMovement && newPosition < d_ptr->lower)
-        {
-            d_ptr->swapControls();
-            setLowerPosition(newPosition);
-        }
-        else
-        {
-            setUpperPosition(newPosition);
-        }
+    {
+        QXT_SPANSLIDER_TRACE_SCOPE("mouseMoveEvent/trackMotion");
+        d_ptr->trackMotion(event->timestamp());
     }
     event->accept();
 }
@@ -711,9 +1770,11 @@ void QxtSpanSlider::mouseReleaseEvent(QMouseEvent* event)
     // 将滑块设置为未按下状态
     setSliderDown(false);
 
-    // 重置下限和上限滑块的按压状态
+    // 重置下限和上限滑块以及跨度的按压状态
     d_ptr->lowerPressed = QStyle::SC_None;
     d_ptr->upperPressed = QStyle::SC_None;
+    d_ptr->spanPressed = false;
+    d_ptr->motion.reset();
 
     // 更新组件的外观
     update();
@@ -728,6 +1789,7 @@ void QxtSpanSlider::paintEvent(QPaintEvent* event)
 {
     // Q_UNUSED 用于标识未使用的参数以避免编译器警告
     Q_UNUSED(event);
+    QXT_SPANSLIDER_TRACE_SCOPE("paintEvent");
 
     // 创建 QStylePainter 对象，用于绘制组件
     QStylePainter painter(this);
@@ -736,48 +1798,62 @@ void QxtSpanSlider::paintEvent(QPaintEvent* event)
     QStyleOptionSlider opt;
     d_ptr->initStyleOption(&opt);
 
-    // 绘制滑槽和刻度标记
-    opt.sliderValue = 0;
-    opt.sliderPosition = 0;
-    opt.subControls = QStyle::SC_SliderGroove | QStyle::SC_SliderTickmarks;
-    painter.drawComplexControl(QStyle::CC_Slider, opt);
-
-    // 计算下限滑块的矩形区域
-    opt.sliderPosition = d_ptr->lowerPos;
-    const QRect lr = style()->subControlRect(QStyle::CC_Slider, &opt, QStyle::SC_SliderHandle, this);
-    const int lrv  = d_ptr->pick(lr.center());
+    // 绘制滑槽后方的叠加层
+    d_ptr->drawOverlay(&painter);
 
-    // 计算上限滑块的矩形区域
-    opt.sliderPosition = d_ptr->upperPos;
-    const QRect ur = style()->subControlRect(QStyle::CC_Slider, &opt, QStyle::SC_SliderHandle, this);
-    const int urv  = d_ptr->pick(ur.center());
+    // 时间轴模式下绘制日历刻度，代替样式的等间隔刻度
+    if (d_ptr->timeAxis)
+    {
+        d_ptr->drawTimeTicks(&painter, opt);
+        opt.tickPosition = QSlider::NoTicks;
+    }
 
-    // 计算 span（滑块之间的范围）的矩形区域
-    const int minv = qMin(lrv, urv);
-    const int maxv = qMax(lrv, urv);
-    const QPoint c = QRect(lr.center(), ur.center()).center();
-    QRect spanRect;
-    if (orientation() == Qt::Horizontal)
-        spanRect = QRect(QPoint(minv, c.y() - 2), QPoint(maxv, c.y() + 1));
-    else
-        spanRect = QRect(QPoint(c.x() - 2, minv), QPoint(c.x() + 1, maxv));
+    // 绘制滑槽、跨度和两个滑块
+    QxtSpanSliderPrivate::PaintState state;
+    state.lower = d_ptr->lower;
+    state.upper = d_ptr->upper;
+    state.lowerPos = d_ptr->lowerPos;
+    state.upperPos = d_ptr->upperPos;
+    state.lowerPressed = d_ptr->lowerPressed;
+    state.upperPressed = d_ptr->upperPressed;
+    state.lastPressed = d_ptr->lastPressed;
+    QxtSpanSliderPrivate::paintSlider(&painter, style(), opt, state, this);
+
+    // 绘制刻度标签和滑块读数
+    if (d_ptr->tickLabelsVisible)
+        d_ptr->drawTickLabels(&painter);
+    if (d_ptr->valueReadoutsVisible)
+        d_ptr->drawValueReadouts(&painter);
+}
 
-    // 绘制 span 的外观
-    d_ptr->drawSpan(&painter, spanRect);
+/*!
+    \reimp
+    尺寸变化时使刻度标签布局失效。
+ */
+void QxtSpanSlider::resizeEvent(QResizeEvent* event)
+{
+    QSlider::resizeEvent(event);
+    d_ptr->invalidateLabels();
+}
 
-    // 根据最后一个被按下的滑块，绘制滑块的外观
-    switch (d_ptr->lastPressed)
+/*!
+    \reimp
+    字体或样式变化时清空文本缓存并使刻度标签布局失效。
+ */
+void QxtSpanSlider::changeEvent(QEvent* event)
+{
+    QSlider::changeEvent(event);
+    switch (event->type())
     {
-    case QxtSpanSlider::LowerHandle:
-        // 优先绘制上限滑块，然后绘制下限滑块
-        d_ptr->drawHandle(&painter, QxtSpanSlider::UpperHandle);
-        d_ptr->drawHandle(&painter, QxtSpanSlider::LowerHandle);
+    case QEvent::FontChange:
+    case QEvent::StyleChange:
+    case QEvent::LayoutDirectionChange:
+        d_ptr->textCache.clear();
+        d_ptr->timeTicks.invalidate();
+        d_ptr->invalidateLabels();
+        updateGeometry();
         break;
-    case QxtSpanSlider::UpperHandle:
     default:
-        // 优先绘制下限滑块，然后绘制上限滑块
-        d_ptr->drawHandle(&painter, QxtSpanSlider::LowerHandle);
-        d_ptr->drawHandle(&painter, QxtSpanSlider::UpperHandle);
         break;
     }
 }
@@ -2,9 +2,19 @@
 #define QXTSPANSLIDER_H
 
 #include <QSlider>
+#include <QImage>
+#include <QPair>
+#include <QPalette>
+#include <QVector>
+#include <functional>
+#include "QxtQuantileSketch.h"
+
+QT_FORWARD_DECLARE_CLASS(QThreadPool)
 
 // 前向声明私有实现类
 class QxtSpanSliderPrivate;
+class QxtSpanSliderOverlay;
+struct QxtSpanSliderRenderOptions;
 
 // QxtSpanSlider 类继承自 QSlider
 class QxtSpanSlider : public QSlider {
@@ -18,6 +28,11 @@ class QxtSpanSlider : public QSlider {
     Q_PROPERTY(int lowerPosition READ lowerPosition WRITE setLowerPosition)
     Q_PROPERTY(int upperPosition READ upperPosition WRITE setUpperPosition)
     Q_PROPERTY(HandleMovementMode handleMovementMode READ handleMovementMode WRITE setHandleMovementMode)
+    Q_PROPERTY(bool tickLabelsVisible READ tickLabelsVisible WRITE setTickLabelsVisible)
+    Q_PROPERTY(bool valueReadoutsVisible READ valueReadoutsVisible WRITE setValueReadoutsVisible)
+    Q_PROPERTY(bool timeAxis READ isTimeAxis WRITE setTimeAxis)
+    Q_PROPERTY(int prefetchHorizon READ prefetchHorizon WRITE setPrefetchHorizon)
+    Q_PROPERTY(bool quantileMode READ isQuantileMode WRITE setQuantileMode)
     Q_ENUMS(HandleMovementMode) // 声明 HandleMovementMode 枚举类型
 
 public:
@@ -40,6 +55,9 @@ public:
         UpperHandle     // 上柄
     };
 
+    // 数值格式化函数：把范围值转换为刻度标签和滑块读数的文本
+    typedef std::function<QString (int)> ValueFormatter;
+
     // 获取和设置滑块柄移动模式
     HandleMovementMode handleMovementMode() const;
     void setHandleMovementMode(HandleMovementMode mode);
@@ -52,11 +70,62 @@ public:
     int lowerPosition() const;
     int upperPosition() const;
 
+    // 刻度标签和滑块读数
+    bool tickLabelsVisible() const;
+    void setTickLabelsVisible(bool visible);
+    bool valueReadoutsVisible() const;
+    void setValueReadoutsVisible(bool visible);
+    ValueFormatter valueFormatter() const;
+    void setValueFormatter(const ValueFormatter& formatter);
+
+    // 时间轴模式：值为 Unix 时间（秒），刻度按日历对齐
+    bool isTimeAxis() const;
+    void setTimeAxis(bool enabled);
+
+    // 分位数模式：滑块位置表示分位数，数值由分位数草图解析
+    bool isQuantileMode() const;
+    void setQuantileMode(bool enabled);
+    QxtQuantileSketch quantileSketch() const;
+    void setQuantileSketch(const QxtQuantileSketch& sketch);
+    qreal lowerQuantile() const;
+    qreal upperQuantile() const;
+    double lowerQuantileValue() const;
+    double upperQuantileValue() const;
+
+    // 拖动速度与加速度的估计（值/秒、值/秒²），以及 msecs 毫秒之后的预测跨度
+    qreal lowerVelocity() const;
+    qreal upperVelocity() const;
+    qreal lowerAcceleration() const;
+    qreal upperAcceleration() const;
+    QPair<int, int> predictedSpan(int msecs) const;
+
+    // 预取的预测时间（毫秒），0 表示不发出 prefetchRequested()
+    int prefetchHorizon() const;
+    void setPrefetchHorizon(int msecs);
+
+    // 批量更新事务：事务内的跨度变化被暂存，提交时按最终的范围和模式统一校验并发出信号（rangeChanged() 除外）
+    void beginUpdate();
+    void commitUpdate();
+    bool isUpdating() const;
+
+    // 后台渲染的叠加层
+    QxtSpanSliderOverlay* overlay() const;
+    void setOverlay(QxtSpanSliderOverlay* overlay);
+
+    // 不创建部件，直接把滑块状态渲染为图像；批量渲染在线程池中并行进行
+    static QImage renderImage(const QxtSpanSliderRenderOptions& options);
+    static QVector<QImage> renderImages(const QVector<QxtSpanSliderRenderOptions>& options, QThreadPool* pool = 0);
+
+    virtual QSize sizeHint() const;
+    virtual QSize minimumSizeHint() const;
+
 public Q_SLOTS:
     // 设置值和位置的槽函数
     void setLowerValue(int lower);
     void setUpperValue(int upper);
     void setSpan(int lower, int upper);
+    void moveSpan(int lower);
+    void setQuantileSpan(qreal lower, qreal upper);
 
     void setLowerPosition(int lower);
     void setUpperPosition(int upper);
@@ -74,6 +143,12 @@ Q_SIGNALS:
     // 滑块柄按下的信号
     void sliderPressed(QxtSpanSlider::SpanHandle handle);
 
+    // 分位数模式下解析出的数值范围变化的信号
+    void quantileSpanChanged(double lower, double upper);
+
+    // 拖动中预测的跨度离开已预取的窗口时发出，请求预取新的窗口
+    void prefetchRequested(int lower, int upper);
+
 protected:
     // 事件处理函数：键盘、鼠标和绘制事件
     virtual void keyPressEvent(QKeyEvent* event);
@@ -81,10 +156,49 @@ protected:
     virtual void mouseMoveEvent(QMouseEvent* event);
     virtual void mouseReleaseEvent(QMouseEvent* event);
     virtual void paintEvent(QPaintEvent* event);
+    virtual void resizeEvent(QResizeEvent* event);
+    virtual void changeEvent(QEvent* event);
 
 private:
     QxtSpanSliderPrivate* d_ptr; // 指向私有实现的指针
     friend class QxtSpanSliderPrivate; // 允许私有实现类访问 QxtSpanSlider 的私有成员
 };
 
+// QxtSpanSliderRenderOptions 描述一个离屏渲染的滑块状态
+struct QxtSpanSliderRenderOptions {
+    QxtSpanSliderRenderOptions();
+
+    int minimum;                         // 范围最小值
+    int maximum;                         // 范围最大值
+    int lower;                           // 跨度下限值
+    int upper;                           // 跨度上限值
+    Qt::Orientation orientation;         // 方向
+    QSize size;                          // 图像尺寸
+    QSlider::TickPosition tickPosition;  // 刻度位置
+    int tickInterval;                    // 刻度间隔
+    int pageStep;                        // 刻度间隔为 0 时使用的步长
+    bool invertedAppearance;             // 是否反向显示
+    QPalette palette;                    // 调色板，背景使用 QPalette::Window
+    QStyle* style;                       // 样式，为 0 时使用 QApplication::style()
+};
+
+// QxtSpanSliderUpdateGuard 在构造时开始、析构时提交 QxtSpanSlider 的批量更新事务
+class QxtSpanSliderUpdateGuard {
+public:
+    explicit QxtSpanSliderUpdateGuard(QxtSpanSlider* slider) : slider(slider)
+    {
+        slider->beginUpdate();
+    }
+
+    ~QxtSpanSliderUpdateGuard()
+    {
+        slider->commitUpdate();
+    }
+
+private:
+    Q_DISABLE_COPY(QxtSpanSliderUpdateGuard)
+
+    QxtSpanSlider* slider;
+};
+
 #endif // QXTSPANSLIDER_H
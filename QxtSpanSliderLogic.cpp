@@ -0,0 +1,65 @@
+#include "QxtSpanSliderLogic_p.h"
+
+bool QxtSpanSliderLogic::targetsUpper(bool main, QxtSpanSlider::SpanHandle mainControl)
+{
+    const QxtSpanSlider::SpanHandle altControl = otherHandle(mainControl);
+    return (main && mainControl == QxtSpanSlider::UpperHandle) || (!main && altControl == QxtSpanSlider::UpperHandle);
+}
+
+QxtSpanSlider::SpanHandle QxtSpanSliderLogic::otherHandle(QxtSpanSlider::SpanHandle handle)
+{
+    return handle == QxtSpanSlider::LowerHandle ? QxtSpanSlider::UpperHandle : QxtSpanSlider::LowerHandle;
+}
+
+bool QxtSpanSliderLogic::actionValue(QAbstractSlider::SliderAction action, int current, int singleStep,
+                                     int minimum, int maximum, int* value)
+{
+    switch (action)
+    {
+    case QAbstractSlider::SliderSingleStepAdd:
+        *value = qBound(minimum, current + singleStep, maximum);
+        return true;
+    case QAbstractSlider::SliderSingleStepSub:
+        *value = qBound(minimum, current - singleStep, maximum);
+        return true;
+    case QAbstractSlider::SliderToMinimum:
+        *value = minimum;
+        return true;
+    case QAbstractSlider::SliderToMaximum:
+        *value = maximum;
+        return true;
+    case QAbstractSlider::SliderMove:
+    case QAbstractSlider::SliderNoAction:
+        return false;
+    default:
+        qWarning("QxtSpanSliderLogic::actionValue: Unknown action");
+        return false;
+    }
+}
+
+QxtSpanSliderLogic::Move QxtSpanSliderLogic::moveHandle(QxtSpanSlider::HandleMovementMode mode, bool upperHandle,
+                                                        int value, int lower, int upper)
+{
+    Move move;
+    move.value = value;
+    move.swap = false;
+    if (!upperHandle)
+    {
+        if (mode == QxtSpanSlider::NoCrossing)
+            move.value = qMin(value, upper);
+        else if (mode == QxtSpanSlider::NoOverlapping)
+            move.value = qMin(value, upper - 1);
+
+        move.swap = (mode == QxtSpanSlider::FreeMovement && move.value > upper);
+    }
+    else
+    {
+        if (mode == QxtSpanSlider::NoCrossing)
+            move.value = qMax(value, lower);
+        else if (mode == QxtSpanSlider::NoOverlapping)
+            move.value = qMax(value, lower + 1);
+
+        move.swap = (mode == QxtSpanSlider::FreeMovement && move.value < lower);
+    }
+    return move;
+}
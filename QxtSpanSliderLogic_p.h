@@ -0,0 +1,32 @@
+#ifndef QXTSPANSLIDERLOGIC_P_H
+#define QXTSPANSLIDERLOGIC_P_H
+
+#include <QAbstractSlider>
+#include "QxtSpanSlider.h"
+
+// QxtSpanSliderLogic 是 QxtSpanSlider 和 QxtQuickSpanSlider 共用的滑块柄移动规则：
+// 动作的目标滑块柄和目标值、按 HandleMovementMode 的限制，以及何时需要交换控制
+class QxtSpanSliderLogic {
+public:
+    // 一次移动的结果：限制后的值，以及是否需要先交换控制（交换后该值作用于另一个滑块柄）
+    struct Move
+    {
+        int value;
+        bool swap;
+    };
+
+    // 动作作用于主控制（main 为 true）还是另一个滑块柄时，目标是否为上限滑块柄
+    static bool targetsUpper(bool main, QxtSpanSlider::SpanHandle mainControl);
+
+    // 另一个滑块柄
+    static QxtSpanSlider::SpanHandle otherHandle(QxtSpanSlider::SpanHandle handle);
+
+    // 计算动作的目标值；SliderMove、SliderNoAction 和不支持的动作返回 false
+    static bool actionValue(QAbstractSlider::SliderAction action, int current, int singleStep,
+                            int minimum, int maximum, int* value);
+
+    // 把下限或上限滑块柄（upperHandle）移到 value：按 mode 限制，自由移动时越过另一个滑块柄则需要交换
+    static Move moveHandle(QxtSpanSlider::HandleMovementMode mode, bool upperHandle, int value, int lower, int upper);
+};
+
+#endif // QXTSPANSLIDERLOGIC_P_H
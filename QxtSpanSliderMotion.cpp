@@ -0,0 +1,145 @@
+#include "QxtSpanSliderMotion_p.h"
+
+namespace
+{
+// 滤波器增益：alpha 修正位置，beta 修正速度，gamma 修正加速度
+const qreal Alpha = 0.5;
+const qreal Beta = 0.4;
+const qreal Gamma = 0.1;
+
+// 超过该时间（毫秒）没有新采样时认为拖动已停顿，估计失效
+const qint64 StaleInterval = 100;
+
+// 外推加速度项的最长时间（秒），避免抛物线在较长的预测时间内发散
+const qreal MaxAccelerationHorizon = 0.25;
+
+// 间隔小于该时间（毫秒）的采样被合并，不用极小的 dt 去除残差
+const qint64 MinimumInterval = 4;
+
+// 速度最多为每 VelocityTime 秒移动整个范围，加速度最多在 VelocityTime 秒内达到最大速度
+const qreal VelocityTime = 0.1;
+} // namespace
+
+void QxtSpanSliderMotion::Channel::reset(qreal value)
+{
+    x = value;
+    v = 0;
+    a = 0;
+}
+
+void QxtSpanSliderMotion::Channel::update(qreal value, qreal dt, qreal maxVelocity, qreal maxAcceleration)
+{
+    // 预测
+    const qreal px = x + v * dt + a * dt * dt / 2;
+    const qreal pv = v + a * dt;
+
+    // 用残差修正
+    const qreal r = value - px;
+    x = px + Alpha * r;
+    v = pv + Beta * r / dt;
+    a = a + 2 * Gamma * r / (dt * dt);
+
+    // 限制在物理上可能的区间内，单个异常采样不会让外推发散
+    v = qBound(-maxVelocity, v, maxVelocity);
+    a = qBound(-maxAcceleration, a, maxAcceleration);
+}
+
+qreal QxtSpanSliderMotion::Channel::predict(qreal t) const
+{
+    const qreal ta = qMin(t, MaxAccelerationHorizon);
+    return x + v * t + a * ta * ta / 2;
+}
+
+QxtSpanSliderMotion::QxtSpanSliderMotion() :
+        lastSample(0),
+        lastTimestamp(0),
+        samples(0)
+{
+    lowerChannel.reset(0);
+    upperChannel.reset(0);
+}
+
+void QxtSpanSliderMotion::reset()
+{
+    samples = 0;
+    lowerChannel.reset(0);
+    upperChannel.reset(0);
+    clock.start();
+}
+
+void QxtSpanSliderMotion::addSample(int lower, int upper, qint64 timestamp, qreal range)
+{
+    if (!clock.isValid())
+        clock.start();
+
+    // dt 取自事件的时间戳而不是处理事件的时刻，繁忙的一帧之后集中到达的事件仍保持原来的间隔
+    const qint64 now = clock.elapsed();
+    const qint64 interval = timestamp - lastTimestamp;
+    if (samples == 0 || interval < 0 || interval > StaleInterval)
+    {
+        // 第一次采样、停顿之后或时间戳回退时重新开始估计
+        lowerChannel.reset(lower);
+        upperChannel.reset(upper);
+        samples = 1;
+        lastSample = now;
+        lastTimestamp = timestamp;
+        return;
+    }
+
+    // 间隔过短的采样合并到下一次更新中：滤波器只用间隔足够的最新位置修正
+    lastSample = now;
+    if (interval < MinimumInterval)
+        return;
+
+    const qreal dt = interval / 1000.0;
+    const qreal maxVelocity = qMax<qreal>(range, 1) / VelocityTime;
+    const qreal maxAcceleration = maxVelocity / VelocityTime;
+    lowerChannel.update(lower, dt, maxVelocity, maxAcceleration);
+    upperChannel.update(upper, dt, maxVelocity, maxAcceleration);
+    ++samples;
+    lastTimestamp = timestamp;
+}
+
+bool QxtSpanSliderMotion::isActive() const
+{
+    return samples > 1 && clock.elapsed() - lastSample <= StaleInterval;
+}
+
+qreal QxtSpanSliderMotion::lowerVelocity() const
+{
+    return isActive() ? lowerChannel.v : 0;
+}
+
+qreal QxtSpanSliderMotion::upperVelocity() const
+{
+    return isActive() ? upperChannel.v : 0;
+}
+
+qreal QxtSpanSliderMotion::lowerAcceleration() const
+{
+    return isActive() ? lowerChannel.a : 0;
+}
+
+qreal QxtSpanSliderMotion::upperAcceleration() const
+{
+    return isActive() ? upperChannel.a : 0;
+}
+
+qreal QxtSpanSliderMotion::predictLower(int msecs) const
+{
+    if (!isActive())
+        return lowerChannel.x;
+    return lowerChannel.predict(elapsedSinceSample() + qMax(msecs, 0) / 1000.0);
+}
+
+qreal QxtSpanSliderMotion::predictUpper(int msecs) const
+{
+    if (!isActive())
+        return upperChannel.x;
+    return upperChannel.predict(elapsedSinceSample() + qMax(msecs, 0) / 1000.0);
+}
+
+qreal QxtSpanSliderMotion::elapsedSinceSample() const
+{
+    return (clock.elapsed() - lastSample) / 1000.0;
+}
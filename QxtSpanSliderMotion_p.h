@@ -0,0 +1,57 @@
+#ifndef QXTSPANSLIDERMOTION_P_H
+#define QXTSPANSLIDERMOTION_P_H
+
+#include <QElapsedTimer>
+#include <QtGlobal>
+
+// QxtSpanSliderMotion 用 alpha-beta-gamma 滤波器从拖动过程中的位置采样估计两个滑块柄的速度和加速度，
+// 并据此外推未来某一时刻的跨度
+class QxtSpanSliderMotion {
+public:
+    // 构造函数
+    QxtSpanSliderMotion();
+
+    // 开始一次新的拖动，清除之前的估计
+    void reset();
+
+    // 加入一个位置采样。timestamp 为事件的时间戳（毫秒，如 QInputEvent::timestamp()），
+    // range 为滑块的范围宽度，用于把速度和加速度限制在物理上合理的区间内
+    void addSample(int lower, int upper, qint64 timestamp, qreal range);
+
+    // 估计是否有效：拖动中且最近的采样没有过时
+    bool isActive() const;
+
+    // 获取估计的速度（值/秒）和加速度（值/秒²），无效时为 0
+    qreal lowerVelocity() const;
+    qreal upperVelocity() const;
+    qreal lowerAcceleration() const;
+    qreal upperAcceleration() const;
+
+    // 外推 msecs 毫秒之后的位置，无效时返回最近的采样
+    qreal predictLower(int msecs) const;
+    qreal predictUpper(int msecs) const;
+
+private:
+    // 单个滑块柄的滤波状态
+    struct Channel
+    {
+        qreal x;
+        qreal v;
+        qreal a;
+
+        void reset(qreal value);
+        void update(qreal value, qreal dt, qreal maxVelocity, qreal maxAcceleration);
+        qreal predict(qreal t) const;
+    };
+
+    qreal elapsedSinceSample() const;
+
+    QElapsedTimer clock;
+    qint64 lastSample;
+    qint64 lastTimestamp;
+    int samples;
+    Channel lowerChannel;
+    Channel upperChannel;
+};
+
+#endif // QXTSPANSLIDERMOTION_P_H
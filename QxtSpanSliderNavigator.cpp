@@ -0,0 +1,242 @@
+#include "QxtSpanSliderNavigator.h"
+#include "QxtSpanSlider.h"
+#include <QBoxLayout>
+
+/*!
+    \class QxtSpanSliderNavigator
+    \inmodule QxtWidgets
+    \brief QxtSpanSliderNavigator 小部件将概览滑块与细节滑块组合成一个缩放导航器。
+
+    当 maximum() - minimum() 远大于滑块的像素长度时，单个 QxtSpanSlider 只能选中每隔 N 个值中的一个。
+    QxtSpanSliderNavigator 使用概览滑块粗略选择一个细节窗口，细节滑块的取值范围始终跟随该窗口，
+    因此窗口内的每一个值都可以以全分辨率选中。
+
+    移动概览滑块时只调整细节滑块的取值范围，细节滑块只重绘一次。
+    细节窗口的变化通过 detailWindowChanged() 延迟到事件循环中合并发出，
+    依赖细节窗口的叠加数据只需针对该窗口按需重新计算。
+ */
+
+/*!
+    \fn QxtSpanSliderNavigator::spanChanged(int lower, int upper)
+    每当细节滑块选择的 \a lower 和 \a upper 值发生变化时，都会发出此信号。
+ */
+
+/*!
+    \fn QxtSpanSliderNavigator::detailWindowChanged(int min, int max)
+    细节窗口变为 \a min 到 \a max 后发出此信号。同一次事件循环中的多次变化只会发出一次。
+ */
+
+/*!
+    使用 \a parent 构造一个新的水平 QxtSpanSliderNavigator。
+ */
+QxtSpanSliderNavigator::QxtSpanSliderNavigator(QWidget* parent) : QWidget(parent)
+{
+    init(Qt::Horizontal);
+}
+
+/*!
+    使用 \a orientation 和 \a parent 构造一个新的 QxtSpanSliderNavigator。
+ */
+QxtSpanSliderNavigator::QxtSpanSliderNavigator(Qt::Orientation orientation, QWidget* parent) : QWidget(parent)
+{
+    init(orientation);
+}
+
+/*!
+    销毁 QxtSpanSliderNavigator 对象。
+ */
+QxtSpanSliderNavigator::~QxtSpanSliderNavigator()
+{
+}
+
+void QxtSpanSliderNavigator::init(Qt::Orientation orientation)
+{
+    windowChangePending = false;
+    overview = new QxtSpanSlider(orientation, this);
+    detail = new QxtSpanSlider(orientation, this);
+
+    // 细节窗口不能为空
+    overview->setHandleMovementMode(QxtSpanSlider::NoOverlapping);
+
+    layout = new QBoxLayout(orientation == Qt::Horizontal ? QBoxLayout::TopToBottom : QBoxLayout::LeftToRight, this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(overview);
+    layout->addWidget(detail);
+
+    connect(overview, SIGNAL(spanChanged(int, int)), this, SLOT(updateDetailRange(int, int)));
+    connect(detail, SIGNAL(spanChanged(int, int)), this, SIGNAL(spanChanged(int, int)));
+    connect(detail, SIGNAL(lowerValueChanged(int)), this, SIGNAL(lowerValueChanged(int)));
+    connect(detail, SIGNAL(upperValueChanged(int)), this, SIGNAL(upperValueChanged(int)));
+
+    // 初始时细节窗口覆盖整体范围
+    overview->setSpan(overview->minimum(), overview->maximum());
+}
+
+/*!
+    返回概览滑块。概览滑块的范围即细节窗口。
+ */
+QxtSpanSlider* QxtSpanSliderNavigator::overviewSlider() const
+{
+    return overview;
+}
+
+/*!
+    返回细节滑块。细节滑块的范围即最终选择的范围。
+ */
+QxtSpanSlider* QxtSpanSliderNavigator::detailSlider() const
+{
+    return detail;
+}
+
+/*!
+    \property QxtSpanSliderNavigator::minimum
+    \brief 整体范围的最小值
+ */
+int QxtSpanSliderNavigator::minimum() const
+{
+    return overview->minimum();
+}
+
+void QxtSpanSliderNavigator::setMinimum(int min)
+{
+    setRange(min, qMax(min, maximum()));
+}
+
+/*!
+    \property QxtSpanSliderNavigator::maximum
+    \brief 整体范围的最大值
+ */
+int QxtSpanSliderNavigator::maximum() const
+{
+    return overview->maximum();
+}
+
+void QxtSpanSliderNavigator::setMaximum(int max)
+{
+    setRange(qMin(minimum(), max), max);
+}
+
+/*!
+    将整体范围设置为 \a min 到 \a max。
+    如果细节窗口原本覆盖整体范围，它会继续覆盖新的范围；否则细节窗口被限制在新的范围内。
+ */
+void QxtSpanSliderNavigator::setRange(int min, int max)
+{
+    const bool whole = (overview->lowerValue() == overview->minimum() && overview->upperValue() == overview->maximum());
+    overview->setRange(min, max);
+    if (whole)
+        overview->setSpan(overview->minimum(), overview->maximum());
+}
+
+/*!
+    返回细节窗口的下限。
+ */
+int QxtSpanSliderNavigator::detailMinimum() const
+{
+    return detail->minimum();
+}
+
+/*!
+    返回细节窗口的上限。
+ */
+int QxtSpanSliderNavigator::detailMaximum() const
+{
+    return detail->maximum();
+}
+
+/*!
+    \property QxtSpanSliderNavigator::lowerValue
+    \brief 最终选择范围的下限值
+ */
+int QxtSpanSliderNavigator::lowerValue() const
+{
+    return detail->lowerValue();
+}
+
+void QxtSpanSliderNavigator::setLowerValue(int lower)
+{
+    setSpan(lower, upperValue());
+}
+
+/*!
+    \property QxtSpanSliderNavigator::upperValue
+    \brief 最终选择范围的上限值
+ */
+int QxtSpanSliderNavigator::upperValue() const
+{
+    return detail->upperValue();
+}
+
+void QxtSpanSliderNavigator::setUpperValue(int upper)
+{
+    setSpan(lowerValue(), upper);
+}
+
+/*!
+    \property QxtSpanSliderNavigator::orientation
+    \brief 两个滑块的方向
+ */
+Qt::Orientation QxtSpanSliderNavigator::orientation() const
+{
+    return overview->orientation();
+}
+
+void QxtSpanSliderNavigator::setOrientation(Qt::Orientation orientation)
+{
+    overview->setOrientation(orientation);
+    detail->setOrientation(orientation);
+    layout->setDirection(orientation == Qt::Horizontal ? QBoxLayout::TopToBottom : QBoxLayout::LeftToRight);
+}
+
+/*!
+    设置最终选择的范围，从 \a lower 到 \a upper。
+    如果该范围超出当前细节窗口，细节窗口会扩大到恰好包含它。
+ */
+void QxtSpanSliderNavigator::setSpan(int lower, int upper)
+{
+    const int low = qMin(lower, upper);
+    const int upp = qMax(lower, upper);
+
+    // 细节窗口和细节跨度一起提交，只发出一次 spanChanged()
+    QxtSpanSliderUpdateGuard guard(detail);
+    if (low < detail->minimum() || upp > detail->maximum())
+        overview->setSpan(qMin(low, overview->lowerValue()), qMax(upp, overview->upperValue()));
+    detail->setSpan(low, upp);
+}
+
+/*!
+    将细节窗口设置为 \a min 到 \a max。
+
+    概览滑块使用 NoOverlapping 模式，细节窗口至少宽一个 singleStep()：更窄的窗口向上扩展，
+    到达概览范围的最大值时向下扩展，避免细节滑块的范围收缩为一个点。
+ */
+void QxtSpanSliderNavigator::setDetailWindow(int min, int max)
+{
+    const qint64 step = qMax(1, overview->singleStep());
+    qint64 low = qBound(qint64(overview->minimum()), qint64(qMin(min, max)), qint64(overview->maximum()));
+    qint64 upp = qBound(qint64(overview->minimum()), qint64(qMax(min, max)), qint64(overview->maximum()));
+    if (upp - low < step)
+    {
+        upp = qMin(low + step, qint64(overview->maximum()));
+        low = qMax(upp - step, qint64(overview->minimum()));
+    }
+    overview->setSpan(int(low), int(upp));
+}
+
+void QxtSpanSliderNavigator::updateDetailRange(int lower, int upper)
+{
+    // setRange() 只发出一次 rangeChanged()，细节滑块借此将范围限制在新窗口内并只重绘一次
+    detail->setRange(lower, upper);
+
+    if (!windowChangePending)
+    {
+        windowChangePending = true;
+        QMetaObject::invokeMethod(this, "emitDetailWindowChanged", Qt::QueuedConnection);
+    }
+}
+
+void QxtSpanSliderNavigator::emitDetailWindowChanged()
+{
+    windowChangePending = false;
+    emit detailWindowChanged(detail->minimum(), detail->maximum());
+}
@@ -0,0 +1,85 @@
+#ifndef QXTSPANSLIDERNAVIGATOR_H
+#define QXTSPANSLIDERNAVIGATOR_H
+
+#include <QWidget>
+
+// 前向声明
+class QxtSpanSlider;
+QT_FORWARD_DECLARE_CLASS(QBoxLayout)
+
+// QxtSpanSliderNavigator 将一个概览滑块和一个细节滑块组合在一起：
+// 概览滑块的范围选择决定细节滑块的取值范围，细节滑块以全分辨率选择最终范围。
+class QxtSpanSliderNavigator : public QWidget {
+    Q_OBJECT
+
+    // 属性声明，用于集成 Qt 的属性系统
+    Q_PROPERTY(int minimum READ minimum WRITE setMinimum)
+    Q_PROPERTY(int maximum READ maximum WRITE setMaximum)
+    Q_PROPERTY(int lowerValue READ lowerValue WRITE setLowerValue)
+    Q_PROPERTY(int upperValue READ upperValue WRITE setUpperValue)
+    Q_PROPERTY(Qt::Orientation orientation READ orientation WRITE setOrientation)
+
+public:
+    // 构造函数
+    explicit QxtSpanSliderNavigator(QWidget* parent = 0);
+    explicit QxtSpanSliderNavigator(Qt::Orientation orientation, QWidget* parent = 0);
+    virtual ~QxtSpanSliderNavigator(); // 析构函数
+
+    // 获取概览滑块和细节滑块
+    QxtSpanSlider* overviewSlider() const;
+    QxtSpanSlider* detailSlider() const;
+
+    // 获取和设置整体范围
+    int minimum() const;
+    void setMinimum(int min);
+    int maximum() const;
+    void setMaximum(int max);
+    void setRange(int min, int max);
+
+    // 获取细节窗口（即概览滑块选择的范围）
+    int detailMinimum() const;
+    int detailMaximum() const;
+
+    // 获取最终选择的下限和上限值
+    int lowerValue() const;
+    int upperValue() const;
+
+    // 获取和设置方向
+    Qt::Orientation orientation() const;
+    void setOrientation(Qt::Orientation orientation);
+
+public Q_SLOTS:
+    // 设置最终选择的范围
+    void setLowerValue(int lower);
+    void setUpperValue(int upper);
+    void setSpan(int lower, int upper);
+
+    // 设置细节窗口
+    void setDetailWindow(int min, int max);
+
+Q_SIGNALS:
+    // 最终选择的范围变化的信号
+    void spanChanged(int lower, int upper);
+    void lowerValueChanged(int lower);
+    void upperValueChanged(int upper);
+
+    // 细节窗口变化的信号，每次事件循环最多发出一次
+    void detailWindowChanged(int min, int max);
+
+private Q_SLOTS:
+    // 概览滑块的范围变化时更新细节滑块的取值范围
+    void updateDetailRange(int lower, int upper);
+
+    // 发出延迟合并后的 detailWindowChanged() 信号
+    void emitDetailWindowChanged();
+
+private:
+    void init(Qt::Orientation orientation);
+
+    QxtSpanSlider* overview;
+    QxtSpanSlider* detail;
+    QBoxLayout* layout;
+    bool windowChangePending;
+};
+
+#endif // QXTSPANSLIDERNAVIGATOR_H
@@ -0,0 +1,130 @@
+#include "QxtSpanSliderOverlay.h"
+#include "QxtSpanSliderOverlay_p.h"
+#include <QImage>
+
+/*!
+    \class QxtSpanSliderOverlayRequest
+    \inmodule QxtWidgets
+    \brief QxtSpanSliderOverlayRequest 描述一次叠加层渲染。
+
+    图像的主轴（水平滑块为 x 轴，垂直滑块为 y 轴）从像素 0 开始对应 minimum，到最后一个像素对应 maximum。
+    滑块在显示时会按 invertedAppearance 等属性自行翻转图像。
+ */
+
+/*!
+    使用渲染代数 \a generation 构造请求，当其不再等于 \a expected 时请求即被取消。
+ */
+QxtSpanSliderOverlayRequest::QxtSpanSliderOverlayRequest(const QAtomicInt* generation, int expected) :
+        minimum(0),
+        maximum(0),
+        orientation(Qt::Horizontal),
+        pass(0),
+        passCount(1),
+        generation(generation),
+        expected(expected)
+{
+}
+
+/*!
+    如果尺寸、范围或数据已经变化、本次渲染的结果不会再被显示，则返回 true。
+ */
+bool QxtSpanSliderOverlayRequest::isCanceled() const
+{
+    return generation->load() != expected;
+}
+
+/*!
+    \class QxtSpanSliderOverlay
+    \inmodule QxtWidgets
+    \brief QxtSpanSliderOverlay 是 QxtSpanSlider 后台叠加层的基类。
+
+    通过 QxtSpanSlider::setOverlay() 设置叠加层后，滑块在自己的工作线程中调用 render() 渲染 QImage，
+    并把完成的图像双缓冲地绘制在滑槽和跨度后方。GUI 线程从不等待渲染。
+
+    渲染分 passCount() 遍进行：第一遍以较低的分辨率快速完成，之后每一遍分辨率加倍，最后一遍为全分辨率。
+    尺寸、范围变化或 invalidate() 会使正在进行的渲染失效，render() 应定期检查
+    QxtSpanSliderOverlayRequest::isCanceled() 并尽早返回。
+
+    \bold {注意:} render() 在工作线程中调用，实现必须自行保护所访问的数据。
+    叠加层必须在使用它的滑块之后销毁，或者先调用 QxtSpanSlider::setOverlay(0)。
+ */
+
+/*!
+    \fn QxtSpanSliderOverlay::changed()
+    叠加层需要重新渲染时发出此信号。
+ */
+
+/*!
+    使用 \a parent 构造一个新的 QxtSpanSliderOverlay。
+ */
+QxtSpanSliderOverlay::QxtSpanSliderOverlay(QObject* parent) : QObject(parent)
+{
+}
+
+/*!
+    销毁 QxtSpanSliderOverlay 对象。
+ */
+QxtSpanSliderOverlay::~QxtSpanSliderOverlay()
+{
+}
+
+/*!
+    返回渐进渲染的遍数。默认值为 2。
+ */
+int QxtSpanSliderOverlay::passCount() const
+{
+    return 2;
+}
+
+/*!
+    \fn QxtSpanSliderOverlay::render(QImage* image, const QxtSpanSliderOverlayRequest& request) const
+    在工作线程中将 \a request 描述的范围渲染到 \a image 中。
+ */
+
+/*!
+    使已有的渲染结果失效，并请求使用此叠加层的滑块重新渲染。
+ */
+void QxtSpanSliderOverlay::invalidate()
+{
+    emit changed();
+}
+
+QxtSpanSliderOverlayJob::QxtSpanSliderOverlayJob(const QxtSpanSliderOverlay* overlay, QObject* receiver, const QAtomicInt* generation) :
+        minimum(0),
+        maximum(0),
+        orientation(Qt::Horizontal),
+        upsideDown(false),
+        overlay(overlay),
+        receiver(receiver),
+        generation(generation),
+        expected(generation->load())
+{
+}
+
+void QxtSpanSliderOverlayJob::run()
+{
+    QxtSpanSliderOverlayRequest request(generation, expected);
+    request.minimum = minimum;
+    request.maximum = maximum;
+    request.orientation = orientation;
+    request.passCount = qMax(1, overlay->passCount());
+
+    for (request.pass = 0; request.pass < request.passCount; ++request.pass)
+    {
+        if (request.isCanceled())
+            return;
+
+        // 每一遍的分辨率是下一遍的一半，最后一遍为全分辨率
+        const int shift = qMin(request.passCount - 1 - request.pass, 8);
+        QImage image(qMax(1, size.width() >> shift), qMax(1, size.height() >> shift), QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::transparent);
+        overlay->render(&image, request);
+
+        if (request.isCanceled())
+            return;
+        if (upsideDown)
+            image = image.mirrored(orientation == Qt::Horizontal, orientation == Qt::Vertical);
+        QMetaObject::invokeMethod(receiver, "overlayRendered", Qt::QueuedConnection,
+                                  Q_ARG(QImage, image), Q_ARG(int, expected));
+    }
+}
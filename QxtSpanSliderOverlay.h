@@ -0,0 +1,52 @@
+#ifndef QXTSPANSLIDEROVERLAY_H
+#define QXTSPANSLIDEROVERLAY_H
+
+#include <QObject>
+#include <QAtomicInt>
+
+QT_FORWARD_DECLARE_CLASS(QImage)
+
+// 一次叠加层渲染的参数，在工作线程中传递给 QxtSpanSliderOverlay::render()
+class QxtSpanSliderOverlayRequest {
+public:
+    QxtSpanSliderOverlayRequest(const QAtomicInt* generation, int expected);
+
+    // 渲染结果是否已经过时（尺寸、范围或数据已变化），渲染实现应定期检查并尽早返回
+    bool isCanceled() const;
+
+    int minimum;                 // 图像主轴起点对应的范围值
+    int maximum;                 // 图像主轴终点对应的范围值
+    Qt::Orientation orientation; // 滑块方向
+    int pass;                    // 当前遍数，0 为最粗的一遍
+    int passCount;               // 总遍数
+
+private:
+    const QAtomicInt* generation;
+    int expected;
+};
+
+// QxtSpanSliderOverlay 是绘制在跨度后方的叠加层（数据密度、热图、事件标记等）的基类。
+// render() 在工作线程中调用，实现必须自行保证所访问数据的线程安全。
+class QxtSpanSliderOverlay : public QObject {
+    Q_OBJECT
+public:
+    // 构造函数
+    explicit QxtSpanSliderOverlay(QObject* parent = 0);
+    virtual ~QxtSpanSliderOverlay(); // 析构函数
+
+    // 渐进渲染的遍数，默认先渲染一遍粗略图像，再渲染一遍全分辨率图像
+    virtual int passCount() const;
+
+    // 在工作线程中将 [request.minimum, request.maximum] 渲染到 image 中，image 已填充为透明
+    virtual void render(QImage* image, const QxtSpanSliderOverlayRequest& request) const = 0;
+
+public Q_SLOTS:
+    // 数据变化后调用，使已有的渲染结果失效
+    void invalidate();
+
+Q_SIGNALS:
+    // 叠加层需要重新渲染的信号
+    void changed();
+};
+
+#endif // QXTSPANSLIDEROVERLAY_H
@@ -0,0 +1,33 @@
+#ifndef QXTSPANSLIDEROVERLAY_P_H
+#define QXTSPANSLIDEROVERLAY_P_H
+
+#include <QRunnable>
+#include <QSize>
+#include <QAtomicInt>
+#include "QxtSpanSliderOverlay.h"
+
+// QxtSpanSliderOverlayJob 在工作线程中依次渲染叠加层的各遍图像，
+// 每完成一遍就以排队连接把图像交给接收者的 overlayRendered(QImage, int) 槽
+class QxtSpanSliderOverlayJob : public QRunnable {
+public:
+    // 构造函数
+    QxtSpanSliderOverlayJob(const QxtSpanSliderOverlay* overlay, QObject* receiver, const QAtomicInt* generation);
+
+    // 工作线程入口
+    virtual void run();
+
+    // 成员变量
+    QSize size;
+    int minimum;
+    int maximum;
+    Qt::Orientation orientation;
+    bool upsideDown;
+
+private:
+    const QxtSpanSliderOverlay* overlay;
+    QObject* receiver;
+    const QAtomicInt* generation;
+    int expected;
+};
+
+#endif // QXTSPANSLIDEROVERLAY_P_H
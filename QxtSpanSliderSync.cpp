@@ -0,0 +1,393 @@
+#include "QxtSpanSliderSync.h"
+#include "QxtSpanSlider.h"
+#include <QCoreApplication>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QAtomicInt>
+#include <QtEndian>
+
+namespace
+{
+// 帧的标识、版本和字节数
+const quint32 FrameMagic = 0x51585353; // "QXSS"
+const quint16 FrameVersion = 1;
+const int FrameBytes = 32;
+
+// 同一进程中多个同步对象的序号，与进程号一起构成来源标识
+QAtomicInt instanceCounter;
+} // namespace
+
+/*!
+    \class QxtSpanSliderSync
+    \inmodule QxtWidgets
+    \brief QxtSpanSliderSync 在多个进程之间同步 QxtSpanSlider 的跨度。
+
+    一个进程调用 listen() 成为中转，其余进程用相同的名字调用 connectToServer()。
+    任一进程的滑块发出 spanChanged() 时，同步对象把跨度编码为 32 字节的定长二进制帧发布出去，
+    中转再把它转发给其他所有进程。帧采用小端字节序，依次为标识、版本、保留字段、64 位代数、64 位来源、下限和上限。
+
+    每个进程在自己已知的最新代数上加一作为新帧的代数；代数相同的帧按来源标识排序，
+    因此多个进程同时拖动时所有进程都会收敛到同一个跨度。
+
+    发送方只为每个对端保留最新的一帧：上一帧尚未写出时，新的跨度直接替换等待中的帧，
+    拖动时不会在套接字中堆积过时的帧。接收方一次读出所有已到达的帧，只取其中最新的一帧，
+    并且只有比已应用的帧更新时才通过一次 setSpan() 应用，不会把应用的结果再次发布出去。
+
+    \code
+    QxtSpanSliderSync* sync = new QxtSpanSliderSync(slider, this);
+    if (!sync->listen("timeline"))
+        sync->connectToServer("timeline");
+    \endcode
+ */
+
+/*!
+    \fn QxtSpanSliderSync::remoteSpanApplied(int lower, int upper, quint64 generation)
+    应用了其他进程发布的、代数为 \a generation 的跨度 [\a lower, \a upper] 后发出此信号。
+ */
+
+/*!
+    \fn QxtSpanSliderSync::peerConnected()
+    与对端建立连接后发出此信号。
+ */
+
+/*!
+    \fn QxtSpanSliderSync::peerDisconnected()
+    与已建立连接的对端断开或出错后发出此信号。从未连接上的对端被移除时不发出此信号。
+ */
+
+/*!
+    构造一个同步 \a slider 的 QxtSpanSliderSync，\a parent 为父对象。调用 listen() 或 connectToServer() 之后才开始同步。
+ */
+QxtSpanSliderSync::QxtSpanSliderSync(QxtSpanSlider* slider, QObject* parent) :
+        QObject(parent),
+        slider(slider),
+        server(0),
+        origin((quint64(QCoreApplication::applicationPid()) << 32) | quint32(instanceCounter.fetchAndAddRelaxed(1))),
+        applying(false),
+        flushScheduled(false)
+{
+    latest.generation = 0;
+    latest.origin = 0;
+    latest.lower = 0;
+    latest.upper = 0;
+    if (slider)
+        connect(slider, SIGNAL(spanChanged(int, int)), this, SLOT(publish(int, int)));
+}
+
+/*!
+    关闭所有连接并销毁 QxtSpanSliderSync 对象。
+ */
+QxtSpanSliderSync::~QxtSpanSliderSync()
+{
+    close();
+}
+
+/*!
+    返回同步的滑块。
+ */
+QxtSpanSlider* QxtSpanSliderSync::spanSlider() const
+{
+    return slider;
+}
+
+/*!
+    作为中转监听名为 \a name 的本地套接字。成功时返回 true；已有其他进程在监听该名字时返回 false。
+
+    上一次异常退出留下的套接字文件会被检测并清除。
+ */
+bool QxtSpanSliderSync::listen(const QString& name)
+{
+    close();
+    server = new QLocalServer(this);
+    connect(server, SIGNAL(newConnection()), this, SLOT(acceptConnection()));
+    if (server->listen(name))
+        return true;
+
+    // 名字被占用时，连接不上说明是残留的套接字文件
+    if (server->serverError() == QAbstractSocket::AddressInUseError)
+    {
+        QLocalSocket probe;
+        probe.connectToServer(name);
+        if (!probe.waitForConnected(100))
+        {
+            QLocalServer::removeServer(name);
+            if (server->listen(name))
+                return true;
+        }
+    }
+
+    delete server;
+    server = 0;
+    return false;
+}
+
+/*!
+    连接到由另一个进程调用 listen(\a name) 建立的中转。连接建立后，中转会发送它已知的最新跨度。
+
+    连接失败时对端被移除，isActive() 随之返回 false。
+ */
+void QxtSpanSliderSync::connectToServer(const QString& name)
+{
+    close();
+    addPeer(new QLocalSocket(this), false);
+    peers.last().socket->connectToServer(name);
+}
+
+/*!
+    停止监听并断开所有连接。
+ */
+void QxtSpanSliderSync::close()
+{
+    delete server;
+    server = 0;
+
+    const QList<Peer> old = peers;
+    peers.clear();
+    for (int i = 0; i < old.size(); ++i)
+    {
+        old.at(i).socket->disconnect(this);
+        old.at(i).socket->abort();
+        old.at(i).socket->deleteLater();
+    }
+}
+
+/*!
+    如果正在监听或存在连接，则返回 true。
+ */
+bool QxtSpanSliderSync::isActive() const
+{
+    return server || !peers.isEmpty();
+}
+
+/*!
+    返回当前的对端数量。作为客户端时为 0 或 1。
+ */
+int QxtSpanSliderSync::peerCount() const
+{
+    return peers.size();
+}
+
+/*!
+    返回最近发布或应用的帧的代数。
+ */
+quint64 QxtSpanSliderSync::generation() const
+{
+    return latest.generation;
+}
+
+/*!
+    返回一帧的字节数。
+ */
+int QxtSpanSliderSync::frameSize()
+{
+    return FrameBytes;
+}
+
+void QxtSpanSliderSync::publish(int lower, int upper)
+{
+    // 应用远端跨度引起的 spanChanged() 不再发布
+    if (applying)
+        return;
+
+    ++latest.generation;
+    latest.origin = origin;
+    latest.lower = lower;
+    latest.upper = upper;
+    enqueue(encode(latest), 0);
+}
+
+void QxtSpanSliderSync::flush()
+{
+    flushScheduled = false;
+    for (int i = 0; i < peers.size(); ++i)
+    {
+        Peer& peer = peers[i];
+        // 上一帧尚未写出的对端等待 bytesWritten()，等待期间新的帧会替换 pending
+        if (peer.pending.isEmpty() || peer.socket->state() != QLocalSocket::ConnectedState
+            || peer.socket->bytesToWrite() > 0)
+            continue;
+        peer.socket->write(peer.pending);
+        peer.pending.clear();
+    }
+}
+
+void QxtSpanSliderSync::acceptConnection()
+{
+    while (server && server->hasPendingConnections())
+    {
+        addPeer(server->nextPendingConnection(), true);
+
+        // 新的对端先收到当前的最新跨度
+        if (latest.generation > 0)
+        {
+            peers.last().pending = encode(latest);
+            scheduleFlush();
+        }
+        emit peerConnected();
+    }
+}
+
+void QxtSpanSliderSync::readFrames()
+{
+    Peer* peer = findPeer(sender());
+    if (!peer)
+        return;
+
+    QLocalSocket* socket = peer->socket;
+    peer->received += socket->readAll();
+
+    // 一次读出所有完整的帧，只保留最新的一帧
+    const int frames = peer->received.size() / FrameBytes;
+    Frame newest = latest;
+    bool found = false;
+    for (int i = 0; i < frames; ++i)
+    {
+        Frame frame;
+        if (!decode(peer->received.constData() + i * FrameBytes, &frame))
+            continue;
+        if (!found || isNewer(frame, newest))
+        {
+            newest = frame;
+            found = true;
+        }
+    }
+    peer->received.remove(0, frames * FrameBytes);
+
+    if (!found || !isNewer(newest, latest))
+        return;
+
+    latest = newest;
+    if (slider)
+    {
+        applying = true;
+        slider->setSpan(newest.lower, newest.upper);
+        applying = false;
+    }
+
+    // 中转把新的帧转发给其他对端
+    if (server)
+        enqueue(encode(newest), socket);
+    emit remoteSpanApplied(newest.lower, newest.upper, newest.generation);
+}
+
+void QxtSpanSliderSync::socketBytesWritten()
+{
+    Peer* peer = findPeer(sender());
+    if (peer && !peer->pending.isEmpty() && peer->socket->bytesToWrite() == 0)
+        scheduleFlush();
+}
+
+void QxtSpanSliderSync::socketConnected()
+{
+    Peer* peer = findPeer(sender());
+    if (!peer)
+        return;
+
+    // 客户端连接建立后写出连接期间积累的帧
+    peer->established = true;
+    scheduleFlush();
+    emit peerConnected();
+}
+
+void QxtSpanSliderSync::socketDisconnected()
+{
+    removePeer(sender());
+}
+
+void QxtSpanSliderSync::socketError()
+{
+    // 连接失败或传输出错的套接字不会再恢复，直接移除；从未连接上的对端也不会留在列表中
+    removePeer(sender());
+}
+
+QByteArray QxtSpanSliderSync::encode(const Frame& frame)
+{
+    QByteArray bytes(FrameBytes, 0);
+    uchar* p = reinterpret_cast<uchar*>(bytes.data());
+    qToLittleEndian<quint32>(FrameMagic, p);
+    qToLittleEndian<quint16>(FrameVersion, p + 4);
+    qToLittleEndian<quint16>(0, p + 6);
+    qToLittleEndian<quint64>(frame.generation, p + 8);
+    qToLittleEndian<quint64>(frame.origin, p + 16);
+    qToLittleEndian<qint32>(frame.lower, p + 24);
+    qToLittleEndian<qint32>(frame.upper, p + 28);
+    return bytes;
+}
+
+bool QxtSpanSliderSync::decode(const char* data, Frame* frame)
+{
+    const uchar* p = reinterpret_cast<const uchar*>(data);
+    if (qFromLittleEndian<quint32>(p) != FrameMagic || qFromLittleEndian<quint16>(p + 4) != FrameVersion)
+        return false;
+    frame->generation = qFromLittleEndian<quint64>(p + 8);
+    frame->origin = qFromLittleEndian<quint64>(p + 16);
+    frame->lower = qFromLittleEndian<qint32>(p + 24);
+    frame->upper = qFromLittleEndian<qint32>(p + 28);
+    return true;
+}
+
+bool QxtSpanSliderSync::isNewer(const Frame& a, const Frame& b)
+{
+    return a.generation > b.generation || (a.generation == b.generation && a.origin > b.origin);
+}
+
+void QxtSpanSliderSync::addPeer(QLocalSocket* socket, bool established)
+{
+    Peer peer;
+    peer.socket = socket;
+    peer.established = established;
+    peers.append(peer);
+    connect(socket, SIGNAL(readyRead()), this, SLOT(readFrames()));
+    connect(socket, SIGNAL(bytesWritten(qint64)), this, SLOT(socketBytesWritten()));
+    connect(socket, SIGNAL(connected()), this, SLOT(socketConnected()));
+    connect(socket, SIGNAL(disconnected()), this, SLOT(socketDisconnected()));
+    connect(socket, SIGNAL(error(QLocalSocket::LocalSocketError)), this, SLOT(socketError()));
+}
+
+void QxtSpanSliderSync::removePeer(QObject* socket)
+{
+    for (int i = 0; i < peers.size(); ++i)
+    {
+        if (peers.at(i).socket == socket)
+        {
+            // 出错后套接字可能还会发出 disconnected()，先断开与它的连接，避免重复移除
+            const bool established = peers.at(i).established;
+            peers.removeAt(i);
+            socket->disconnect(this);
+            socket->deleteLater();
+            if (established)
+                emit peerDisconnected();
+            return;
+        }
+    }
+}
+
+QxtSpanSliderSync::Peer* QxtSpanSliderSync::findPeer(QObject* socket)
+{
+    for (int i = 0; i < peers.size(); ++i)
+    {
+        if (peers.at(i).socket == socket)
+            return &peers[i];
+    }
+    return 0;
+}
+
+void QxtSpanSliderSync::enqueue(const QByteArray& frame, QLocalSocket* except)
+{
+    // 每个对端只保留最新的一帧
+    for (int i = 0; i < peers.size(); ++i)
+    {
+        if (peers.at(i).socket != except)
+            peers[i].pending = frame;
+    }
+    scheduleFlush();
+}
+
+void QxtSpanSliderSync::scheduleFlush()
+{
+    if (!flushScheduled)
+    {
+        flushScheduled = true;
+        QMetaObject::invokeMethod(this, "flush", Qt::QueuedConnection);
+    }
+}
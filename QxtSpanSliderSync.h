@@ -0,0 +1,106 @@
+#ifndef QXTSPANSLIDERSYNC_H
+#define QXTSPANSLIDERSYNC_H
+
+#include <QObject>
+#include <QPointer>
+#include <QList>
+#include <QByteArray>
+
+QT_FORWARD_DECLARE_CLASS(QLocalServer)
+QT_FORWARD_DECLARE_CLASS(QLocalSocket)
+
+// 前向声明
+class QxtSpanSlider;
+
+// QxtSpanSliderSync 通过 QLocalServer/QLocalSocket 在多个进程之间同步 QxtSpanSlider 的跨度。
+// 一个进程调用 listen() 作为中转，其余进程调用 connectToServer()；每次跨度变化以定长二进制帧发布，
+// 帧中带有代数，接收方只应用最新的一帧
+class QxtSpanSliderSync : public QObject {
+    Q_OBJECT
+public:
+    // 构造函数
+    explicit QxtSpanSliderSync(QxtSpanSlider* slider, QObject* parent = 0);
+    virtual ~QxtSpanSliderSync(); // 析构函数
+
+    // 获取同步的滑块
+    QxtSpanSlider* spanSlider() const;
+
+    // 作为中转监听本地套接字 name，或者连接到它
+    bool listen(const QString& name);
+    void connectToServer(const QString& name);
+    void close();
+
+    // 是否正在监听或已连接，以及已连接的对端数量
+    bool isActive() const;
+    int peerCount() const;
+
+    // 最近发布或应用的帧的代数
+    quint64 generation() const;
+
+    // 一帧的字节数
+    static int frameSize();
+
+Q_SIGNALS:
+    // 应用了其他进程发布的跨度
+    void remoteSpanApplied(int lower, int upper, quint64 generation);
+
+    // 对端连接和断开的信号
+    void peerConnected();
+    void peerDisconnected();
+
+private Q_SLOTS:
+    // 本地跨度变化时发布
+    void publish(int lower, int upper);
+
+    // 在事件循环中把待发送的最新帧写出
+    void flush();
+
+    // 套接字事件
+    void acceptConnection();
+    void readFrames();
+    void socketConnected();
+    void socketBytesWritten();
+    void socketDisconnected();
+    void socketError();
+
+private:
+    // 一个对端：套接字、是否已建立连接、未读完的数据和等待写出的最新一帧
+    struct Peer
+    {
+        QLocalSocket* socket;
+        bool established;
+        QByteArray received;
+        QByteArray pending;
+    };
+
+    // 帧的内容
+    struct Frame
+    {
+        quint64 generation;
+        quint64 origin;
+        qint32 lower;
+        qint32 upper;
+    };
+
+    static QByteArray encode(const Frame& frame);
+    static bool decode(const char* data, Frame* frame);
+
+    // 帧 a 是否比帧 b 新：先比较代数，代数相同时比较来源，使所有进程得到相同的结果
+    static bool isNewer(const Frame& a, const Frame& b);
+
+    void addPeer(QLocalSocket* socket, bool established);
+    void removePeer(QObject* socket);
+    Peer* findPeer(QObject* socket);
+    void enqueue(const QByteArray& frame, QLocalSocket* except);
+    void scheduleFlush();
+
+    QPointer<QxtSpanSlider> slider;
+    QLocalServer* server;
+    QList<Peer> peers;
+    quint64 origin;
+    Frame latest;
+    bool applying;
+    bool flushScheduled;
+};
+
+#endif // QXTSPANSLIDERSYNC_H
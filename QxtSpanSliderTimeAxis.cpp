@@ -0,0 +1,244 @@
+#include "QxtSpanSliderTimeAxis_p.h"
+#include <QStyle>
+
+namespace
+{
+const qint64 SecsPerMinute = 60;
+const qint64 SecsPerHour = 60 * SecsPerMinute;
+const qint64 SecsPerDay = 24 * SecsPerHour;
+
+QDateTime localTime(qint64 value)
+{
+    return QDateTime::fromSecsSinceEpoch(value);
+}
+
+// 本地日期和墙上时间对应的秒数。夏令时切换跳过的时间（包括某些时区中的午夜）无效，
+// 此时取其后第一个有效的分钟
+qint64 localSecs(const QDate& date, const QTime& time)
+{
+    QDateTime dt(date, time);
+    const qint64 minute = time.msecsSinceStartOfDay() / 60000;
+    for (qint64 m = minute + 1; !dt.isValid() && m <= minute + 24 * 60; ++m)
+        dt = QDateTime(date.addDays(m / (24 * 60)), QTime(0, 0).addSecs(int(m % (24 * 60) * SecsPerMinute)));
+    return dt.toSecsSinceEpoch();
+}
+
+qint64 startOfDay(const QDate& date)
+{
+    return localSecs(date, QTime(0, 0));
+}
+
+// 在墙上时间上加 secs 秒（可以为负），跨过夏令时切换时整点仍落在整点上
+qint64 addWallClock(qint64 value, qint64 secs)
+{
+    const QDateTime dt = localTime(value);
+    qint64 total = dt.time().msecsSinceStartOfDay() / 1000 + secs;
+    qint64 days = total / SecsPerDay;
+    total %= SecsPerDay;
+    if (total < 0)
+    {
+        total += SecsPerDay;
+        --days;
+    }
+    const qint64 result = localSecs(dt.date().addDays(days), QTime(0, 0).addSecs(int(total)));
+
+    // 回拨时重复的时间可能解析到另一次出现，此时退回按绝对时间前进
+    if ((secs > 0 && result <= value) || (secs < 0 && result >= value))
+        return value + secs;
+    return result;
+}
+} // namespace
+
+QxtSpanSliderTimeAxis::QxtSpanSliderTimeAxis() :
+        minimum(0),
+        maximum(0),
+        origin(0),
+        length(0),
+        upsideDown(false),
+        spacing(0),
+        valid(false),
+        step(0)
+{
+}
+
+const QxtSpanSliderTimeAxis::Step* QxtSpanSliderTimeAxis::chooseStep(qint64 range, int length, int spacing)
+{
+    // 按近似时长升序排列的候选步长
+    static const Step steps[] = {
+        { Second, 1, 1 }, { Second, 2, 2 }, { Second, 5, 5 }, { Second, 10, 10 }, { Second, 15, 15 }, { Second, 30, 30 },
+        { Minute, 1, SecsPerMinute }, { Minute, 2, 2 * SecsPerMinute }, { Minute, 5, 5 * SecsPerMinute },
+        { Minute, 10, 10 * SecsPerMinute }, { Minute, 15, 15 * SecsPerMinute }, { Minute, 30, 30 * SecsPerMinute },
+        { Hour, 1, SecsPerHour }, { Hour, 2, 2 * SecsPerHour }, { Hour, 3, 3 * SecsPerHour },
+        { Hour, 6, 6 * SecsPerHour }, { Hour, 12, 12 * SecsPerHour },
+        { Day, 1, SecsPerDay }, { Day, 2, 2 * SecsPerDay }, { Week, 1, 7 * SecsPerDay },
+        { Month, 1, 30 * SecsPerDay }, { Month, 2, 61 * SecsPerDay }, { Month, 3, 91 * SecsPerDay }, { Month, 6, 182 * SecsPerDay },
+        { Year, 1, 365 * SecsPerDay }, { Year, 2, 730 * SecsPerDay }, { Year, 5, 1826 * SecsPerDay },
+        { Year, 10, 3652 * SecsPerDay }, { Year, 20, 7305 * SecsPerDay }, { Year, 50, 18262 * SecsPerDay },
+        { Year, 100, 36525 * SecsPerDay }
+    };
+    const int count = int(sizeof(steps) / sizeof(steps[0]));
+
+    // 选择使相邻刻度间距不小于 spacing 像素的最小步长
+    for (int i = 0; i < count; ++i)
+    {
+        if (steps[i].seconds * length >= qint64(spacing) * range)
+            return &steps[i];
+    }
+    return &steps[count - 1];
+}
+
+qint64 QxtSpanSliderTimeAxis::alignDown(qint64 value) const
+{
+    const QDateTime dt = localTime(value);
+    const QDate date = dt.date();
+    switch (step->unit)
+    {
+    case Second:
+    case Minute:
+    case Hour:
+    {
+        // 在墙上时间的字段上对齐，夏令时切换当天的整点刻度也不会偏移
+        const qint64 secs = dt.time().msecsSinceStartOfDay() / 1000;
+        const qint64 aligned = localSecs(date, QTime(0, 0).addSecs(int(secs - secs % step->seconds)));
+        // 回拨时重复的时间可能解析到较晚的一次出现
+        return aligned <= value ? aligned : value - secs % step->seconds;
+    }
+    case Day:
+    {
+        const qint64 julian = date.toJulianDay();
+        return startOfDay(QDate::fromJulianDay(julian - julian % step->count));
+    }
+    case Week:
+        return startOfDay(date.addDays(1 - date.dayOfWeek()));
+    case Month:
+    {
+        const int index = date.year() * 12 + date.month() - 1;
+        const int aligned = index - index % step->count;
+        return startOfDay(QDate(aligned / 12, aligned % 12 + 1, 1));
+    }
+    case Year:
+    default:
+        return startOfDay(QDate(date.year() - date.year() % step->count, 1, 1));
+    }
+}
+
+qint64 QxtSpanSliderTimeAxis::advance(qint64 value, int direction) const
+{
+    switch (step->unit)
+    {
+    case Second:
+    case Minute:
+    case Hour:
+        return addWallClock(value, direction * step->seconds);
+    case Day:
+        return startOfDay(localTime(value).date().addDays(direction * step->count));
+    case Week:
+        return startOfDay(localTime(value).date().addDays(direction * 7));
+    case Month:
+        return startOfDay(localTime(value).date().addMonths(direction * step->count));
+    case Year:
+    default:
+        return startOfDay(localTime(value).date().addYears(direction * step->count));
+    }
+}
+
+void QxtSpanSliderTimeAxis::generate(qint64 from, qint64 to, QVector<qint64>* out) const
+{
+    // 刻度数受像素长度限制，额外的上限防止异常输入导致的长循环
+    const int limit = qMax(2, length + 2);
+    qint64 value = alignDown(from);
+    if (value < from)
+        value = advance(value, 1);
+    for (; value <= to && out->size() < limit; value = advance(value, 1))
+        out->append(value);
+}
+
+bool QxtSpanSliderTimeAxis::update(int minimum, int maximum, int origin, int length, bool upsideDown, int spacing)
+{
+    if (valid && this->minimum == minimum && this->maximum == maximum && this->origin == origin
+        && this->length == length && this->upsideDown == upsideDown && this->spacing == spacing)
+        return false;
+
+    const qint64 range = qint64(maximum) - minimum;
+    const Step* newStep = (range > 0 && length > 0) ? chooseStep(range, length, qMax(1, spacing)) : 0;
+
+    QVector<qint64> values;
+    if (newStep)
+    {
+        const bool reuse = valid && newStep == step && !tickValues.isEmpty()
+                        && tickValues.first() <= maximum && tickValues.last() >= minimum;
+        step = newStep;
+        if (reuse)
+        {
+            // 步长不变时保留仍在范围内的刻度，只在两端补充新的刻度
+            QVector<qint64> front;
+            for (qint64 value = advance(tickValues.first(), -1); value >= minimum && front.size() < length + 2; value = advance(value, -1))
+                front.append(value);
+            values.reserve(front.size() + tickValues.size());
+            for (int i = front.size() - 1; i >= 0; --i)
+                values.append(front.at(i));
+            for (int i = 0; i < tickValues.size(); ++i)
+            {
+                if (tickValues.at(i) >= minimum && tickValues.at(i) <= maximum)
+                    values.append(tickValues.at(i));
+            }
+            const qint64 last = values.isEmpty() ? qint64(minimum) : advance(values.last(), 1);
+            generate(last, maximum, &values);
+        }
+        else
+        {
+            generate(minimum, maximum, &values);
+        }
+    }
+    step = newStep;
+
+    tickValues = values;
+    tickPositions.resize(tickValues.size());
+    for (int i = 0; i < tickValues.size(); ++i)
+        tickPositions[i] = origin + QStyle::sliderPositionFromValue(minimum, maximum, int(tickValues.at(i)), length, upsideDown);
+
+    this->minimum = minimum;
+    this->maximum = maximum;
+    this->origin = origin;
+    this->length = length;
+    this->upsideDown = upsideDown;
+    this->spacing = spacing;
+    valid = true;
+    return true;
+}
+
+void QxtSpanSliderTimeAxis::invalidate()
+{
+    valid = false;
+}
+
+const QVector<qint64>& QxtSpanSliderTimeAxis::values() const
+{
+    return tickValues;
+}
+
+const QVector<int>& QxtSpanSliderTimeAxis::positions() const
+{
+    return tickPositions;
+}
+
+QString QxtSpanSliderTimeAxis::label(qint64 value) const
+{
+    const QDateTime dt = localTime(value);
+    switch (step ? step->unit : Second)
+    {
+    case Second:
+        return dt.toString(QLatin1String("hh:mm:ss"));
+    case Minute:
+    case Hour:
+        return dt.toString(QLatin1String("hh:mm"));
+    case Day:
+    case Week:
+        return dt.toString(QLatin1String("MM-dd"));
+    case Month:
+        return dt.toString(QLatin1String("yyyy-MM"));
+    case Year:
+    default:
+        return dt.toString(QLatin1String("yyyy"));
+    }
+}
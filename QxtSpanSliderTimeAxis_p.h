@@ -0,0 +1,64 @@
+#ifndef QXTSPANSLIDERTIMEAXIS_P_H
+#define QXTSPANSLIDERTIMEAXIS_P_H
+
+#include <QDateTime>
+#include <QString>
+#include <QVector>
+
+// QxtSpanSliderTimeAxis 为以 Unix 时间（秒）为值的滑块选择日历对齐的刻度，
+// 并缓存刻度的值和像素位置，只在范围、像素长度或间距变化时增量更新
+class QxtSpanSliderTimeAxis {
+public:
+    // 构造函数
+    QxtSpanSliderTimeAxis();
+
+    // 更新刻度：origin 为 minimum 对应的像素位置，length 为像素长度，spacing 为相邻刻度的最小像素间距。
+    // 刻度发生变化时返回 true
+    bool update(int minimum, int maximum, int origin, int length, bool upsideDown, int spacing);
+
+    // 使缓存失效
+    void invalidate();
+
+    // 获取刻度的值、像素位置和标签
+    const QVector<qint64>& values() const;
+    const QVector<int>& positions() const;
+    QString label(qint64 value) const;
+
+private:
+    // 枚举：刻度的日历单位
+    enum Unit {
+        Second,
+        Minute,
+        Hour,
+        Day,
+        Week,
+        Month,
+        Year
+    };
+
+    // 刻度步长
+    struct Step
+    {
+        Unit unit;
+        int count;
+        qint64 seconds; // 近似的秒数，用于选择步长
+    };
+
+    static const Step* chooseStep(qint64 range, int length, int spacing);
+    qint64 alignDown(qint64 value) const;
+    qint64 advance(qint64 value, int direction) const;
+    void generate(qint64 from, qint64 to, QVector<qint64>* out) const;
+
+    int minimum;
+    int maximum;
+    int origin;
+    int length;
+    bool upsideDown;
+    int spacing;
+    bool valid;
+    const Step* step;
+    QVector<qint64> tickValues;
+    QVector<int> tickPositions;
+};
+
+#endif // QXTSPANSLIDERTIMEAXIS_P_H
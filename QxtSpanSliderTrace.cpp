@@ -0,0 +1,313 @@
+#include "QxtSpanSliderTrace.h"
+#include <QAtomicInt>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QIODevice>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QVector>
+#include <algorithm>
+
+namespace
+{
+struct TraceEvent
+{
+    const char* name;
+    qint64 begin;
+    qint64 end;
+};
+
+// 每个线程一个缓冲区，只有所属线程写入，写满后丢弃新事件，因此记录时不需要加锁
+struct ThreadBuffer
+{
+    enum { Capacity = 1 << 16 };
+
+    int tid;
+    QByteArray threadName;
+    QAtomicInt count;
+    TraceEvent events[Capacity];
+};
+
+// 已结束线程的事件的紧凑副本
+struct RetiredThread
+{
+    int tid;
+    QByteArray threadName;
+    QVector<TraceEvent> events;
+};
+
+// 所有线程的事件记录。线程结束时缓冲区中的事件被复制为 RetiredThread，缓冲区留给之后的线程复用
+struct Registry
+{
+    enum {
+        MaximumRetiredEvents = ThreadBuffer::Capacity, // 已结束线程最多保留的事件数
+        MaximumSpareBuffers = 2                       // 最多保留的空闲缓冲区数
+    };
+
+    Registry() : nextTid(1), retiredEvents(0) {}
+
+    QMutex mutex;
+    QVector<ThreadBuffer*> live;
+    QList<RetiredThread> retired;
+    QVector<ThreadBuffer*> spare;
+    int nextTid;
+    int retiredEvents;
+};
+
+QAtomicInt traceEnabled;
+
+Registry& registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+// 把结束的线程的事件移出缓冲区，并回收或释放缓冲区
+void retireBuffer(ThreadBuffer* buffer)
+{
+    Registry& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    reg.live.removeOne(buffer);
+
+    const int count = buffer->count.loadAcquire();
+    if (count > 0)
+    {
+        RetiredThread thread;
+        thread.tid = buffer->tid;
+        thread.threadName = buffer->threadName;
+        thread.events.resize(count);
+        std::copy(buffer->events, buffer->events + count, thread.events.begin());
+        reg.retired.append(thread);
+        reg.retiredEvents += count;
+
+        // 超出上限时丢弃最早结束的线程
+        while (reg.retiredEvents > Registry::MaximumRetiredEvents)
+        {
+            reg.retiredEvents -= reg.retired.first().events.size();
+            reg.retired.removeFirst();
+        }
+    }
+
+    if (reg.spare.size() < Registry::MaximumSpareBuffers)
+        reg.spare.append(buffer);
+    else
+        delete buffer;
+}
+
+// 线程局部的缓冲区所有者，线程结束时交还缓冲区
+struct BufferOwner
+{
+    BufferOwner() : buffer(0) {}
+    ~BufferOwner()
+    {
+        if (buffer)
+            retireBuffer(buffer);
+    }
+
+    ThreadBuffer* buffer;
+};
+
+ThreadBuffer* currentBuffer()
+{
+    static thread_local BufferOwner owner;
+    if (!owner.buffer)
+    {
+        QThread* thread = QThread::currentThread();
+        Registry& reg = registry();
+        QMutexLocker locker(&reg.mutex);
+        ThreadBuffer* buffer = reg.spare.isEmpty() ? new ThreadBuffer : reg.spare.takeLast();
+        buffer->tid = reg.nextTid++;
+        buffer->count.store(0);
+        if (!thread->objectName().isEmpty())
+            buffer->threadName = thread->objectName().toUtf8();
+        else if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread())
+            buffer->threadName = "GUI";
+        else
+            buffer->threadName = "Thread " + QByteArray::number(buffer->tid);
+        reg.live.append(buffer);
+        owner.buffer = buffer;
+    }
+    return owner.buffer;
+}
+
+void appendJsonString(QByteArray& out, const char* text)
+{
+    static const char hex[] = "0123456789abcdef";
+    out += '"';
+    for (const char* c = text; *c; ++c)
+    {
+        const uchar ch = uchar(*c);
+        if (ch == '"' || ch == '\\')
+        {
+            out += '\\';
+            out += *c;
+        }
+        else if (ch < 0x20)
+        {
+            // 控制字符必须转义为 \u00XX
+            out += "\\u00";
+            out += hex[ch >> 4];
+            out += hex[ch & 0xf];
+        }
+        else
+        {
+            out += *c;
+        }
+    }
+    out += '"';
+}
+
+QElapsedTimer startedTimer()
+{
+    QElapsedTimer timer;
+    timer.start();
+    return timer;
+}
+
+// 微秒，保留纳秒精度
+QByteArray micros(qint64 nsecs)
+{
+    return QByteArray::number(double(nsecs) / 1000.0, 'f', 3);
+}
+
+// 导出一个线程的名字和事件
+void appendThread(QByteArray& out, const QByteArray& pid, int tid, const QByteArray& threadName,
+                  const TraceEvent* events, int count)
+{
+    const QByteArray tidText = QByteArray::number(tid);
+    if (!out.endsWith('['))
+        out += ',';
+    out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid + ",\"tid\":" + tidText + ",\"args\":{\"name\":";
+    appendJsonString(out, threadName.constData());
+    out += "}}";
+
+    for (int e = 0; e < count; ++e)
+    {
+        const TraceEvent& event = events[e];
+        out += ",{\"name\":";
+        appendJsonString(out, event.name);
+        out += ",\"cat\":\"QxtSpanSlider\",\"ph\":\"X\",\"ts\":" + micros(event.begin)
+             + ",\"dur\":" + micros(event.end - event.begin)
+             + ",\"pid\":" + pid + ",\"tid\":" + tidText + '}';
+    }
+}
+} // namespace
+
+/*!
+    \class QxtSpanSliderTrace
+    \inmodule QxtWidgets
+    \brief QxtSpanSliderTrace 记录 QxtSpanSlider 事件处理的耗时。
+
+    在 testUI.pro 中定义 QXT_SPANSLIDER_TRACE 后，QxtSpanSlider 会在以下路径上编译跟踪点：
+    mouseMoveEvent 及其各个阶段（选择滑块、移动滑块、运动估计）、triggerAction()、setSpan() 及其各个信号的发出
+    （包含直接连接的槽函数的耗时）、paintEvent 及其各个阶段（叠加层、滑槽、跨度、每个滑块、标签）。
+    未定义时跟踪点不产生任何代码；定义后仍需调用 setEnabled(true) 才会记录。
+
+    每个线程的事件写入各自的固定容量缓冲区，记录时不加锁。缓冲区写满后新事件被丢弃。
+    线程结束时（包括线程池中过期的工作线程），已记录的事件被复制为紧凑的副本供导出，缓冲区留给之后的线程复用或被释放；
+    已结束线程的副本总共最多保留一个缓冲区容量的事件，超出时丢弃最早结束的线程。
+    toChromeJson() 导出的 JSON 可以直接由 chrome://tracing 或 ui.perfetto.dev 打开，
+    连接到 spanChanged() 的缓慢槽函数会直接显示在时间线上。
+
+    \code
+    QxtSpanSliderTrace::setEnabled(true);
+    // ... 拖动滑块 ...
+    QFile file("slider.json");
+    if (file.open(QIODevice::WriteOnly))
+        QxtSpanSliderTrace::writeChromeJson(&file);
+    \endcode
+ */
+
+/*!
+    如果正在记录事件，则返回 true。默认不记录。
+ */
+bool QxtSpanSliderTrace::isEnabled()
+{
+    return traceEnabled.load() != 0;
+}
+
+/*!
+    开始或停止记录事件 \a enabled。
+ */
+void QxtSpanSliderTrace::setEnabled(bool enabled)
+{
+    timestamp();
+    traceEnabled.store(enabled ? 1 : 0);
+}
+
+/*!
+    清空所有线程已记录的事件。只应在没有线程正在记录时调用。
+ */
+void QxtSpanSliderTrace::clear()
+{
+    Registry& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    for (int i = 0; i < reg.live.size(); ++i)
+        reg.live.at(i)->count.store(0);
+    reg.retired.clear();
+    reg.retiredEvents = 0;
+}
+
+/*!
+    返回从第一次使用跟踪起经过的纳秒数。
+ */
+qint64 QxtSpanSliderTrace::timestamp()
+{
+    static const QElapsedTimer timer = startedTimer();
+    return timer.nsecsElapsed();
+}
+
+/*!
+    在当前线程的缓冲区中记录名为 \a name、从 \a begin 到 \a end 的事件。
+    \a name 必须在导出之前一直有效，通常是字符串字面量。
+ */
+void QxtSpanSliderTrace::record(const char* name, qint64 begin, qint64 end)
+{
+    ThreadBuffer* buffer = currentBuffer();
+    const int index = buffer->count.load();
+    if (index >= ThreadBuffer::Capacity)
+        return;
+
+    TraceEvent& event = buffer->events[index];
+    event.name = name;
+    event.begin = begin;
+    event.end = end;
+    buffer->count.storeRelease(index + 1);
+}
+
+/*!
+    将所有线程已记录的事件导出为 Chrome trace-event JSON。
+ */
+QByteArray QxtSpanSliderTrace::toChromeJson()
+{
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+    QByteArray out;
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    Registry& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    for (int i = 0; i < reg.retired.size(); ++i)
+    {
+        const RetiredThread& thread = reg.retired.at(i);
+        appendThread(out, pid, thread.tid, thread.threadName, thread.events.constData(), thread.events.size());
+    }
+    for (int i = 0; i < reg.live.size(); ++i)
+    {
+        const ThreadBuffer* buffer = reg.live.at(i);
+        appendThread(out, pid, buffer->tid, buffer->threadName, buffer->events, buffer->count.loadAcquire());
+    }
+
+    out += "]}";
+    return out;
+}
+
+/*!
+    将 toChromeJson() 的结果写入 \a device。写入成功时返回 true。
+ */
+bool QxtSpanSliderTrace::writeChromeJson(QIODevice* device)
+{
+    const QByteArray json = toChromeJson();
+    return device->write(json) == json.size();
+}
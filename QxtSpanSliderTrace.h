@@ -0,0 +1,61 @@
+#ifndef QXTSPANSLIDERTRACE_H
+#define QXTSPANSLIDERTRACE_H
+
+#include <QtGlobal>
+#include <QByteArray>
+
+QT_FORWARD_DECLARE_CLASS(QIODevice)
+
+// QxtSpanSliderTrace 记录 QxtSpanSlider 事件处理路径上的耗时，并导出为 Chrome trace-event JSON
+class QxtSpanSliderTrace {
+public:
+    // 获取和设置是否记录
+    static bool isEnabled();
+    static void setEnabled(bool enabled);
+
+    // 清空所有线程已记录的事件，只应在没有线程正在记录时调用
+    static void clear();
+
+    // 导出为 Chrome trace-event JSON（可由 chrome://tracing 或 Perfetto 打开）
+    static QByteArray toChromeJson();
+    static bool writeChromeJson(QIODevice* device);
+
+    // 单调时钟，单位为纳秒
+    static qint64 timestamp();
+
+    // 在当前线程的缓冲区中记录一个事件，name 必须是静态字符串
+    static void record(const char* name, qint64 begin, qint64 end);
+};
+
+// QxtSpanSliderTraceScope 在构造和析构之间记录一个事件
+class QxtSpanSliderTraceScope {
+public:
+    explicit QxtSpanSliderTraceScope(const char* name) :
+            name(QxtSpanSliderTrace::isEnabled() ? name : 0),
+            begin(this->name ? QxtSpanSliderTrace::timestamp() : 0)
+    {
+    }
+
+    ~QxtSpanSliderTraceScope()
+    {
+        if (name)
+            QxtSpanSliderTrace::record(name, begin, QxtSpanSliderTrace::timestamp());
+    }
+
+private:
+    Q_DISABLE_COPY(QxtSpanSliderTraceScope)
+
+    const char* name;
+    qint64 begin;
+};
+
+// 只有定义了 QXT_SPANSLIDER_TRACE 时才编译跟踪点
+#ifdef QXT_SPANSLIDER_TRACE
+#  define QXT_SPANSLIDER_TRACE_CONCAT_(a, b) a##b
+#  define QXT_SPANSLIDER_TRACE_CONCAT(a, b) QXT_SPANSLIDER_TRACE_CONCAT_(a, b)
+#  define QXT_SPANSLIDER_TRACE_SCOPE(name) QxtSpanSliderTraceScope QXT_SPANSLIDER_TRACE_CONCAT(qxtTraceScope, __LINE__)(name)
+#else
+#  define QXT_SPANSLIDER_TRACE_SCOPE(name) do { } while (0)
+#endif
+
+#endif // QXTSPANSLIDERTRACE_H
@@ -3,18 +3,30 @@
 
 #include <QStyle>
 #include <QObject>
+#include <QHash>
+#include <QImage>
+#include <QPointer>
+#include <QAtomicInt>
+#include <QSize>
+#include <QPointF>
+#include <QStaticText>
+#include <QVector>
 #include "QxtSpanSlider.h"
+#include "QxtSpanSliderTimeAxis_p.h"
+#include "QxtSpanSliderMotion_p.h"
 
 // 前向声明类
 QT_FORWARD_DECLARE_CLASS(QStylePainter)
 QT_FORWARD_DECLARE_CLASS(QStyleOptionSlider)
+QT_FORWARD_DECLARE_CLASS(QThreadPool)
 
 // QxtSpanSliderPrivate 类继承自 QObject
 class QxtSpanSliderPrivate : public QObject {
     Q_OBJECT
 public:
-    // 构造函数
+    // 构造函数和析构函数
     QxtSpanSliderPrivate();
+    ~QxtSpanSliderPrivate();
 
     // 初始化样式选项
     void initStyleOption(QStyleOptionSlider* option, QxtSpanSlider::SpanHandle handle = QxtSpanSlider::UpperHandle) const;
@@ -25,27 +37,125 @@ public:
         return q_ptr->orientation() == Qt::Horizontal ? pt.x() : pt.y();
     }
 
+    // 计算滑块柄可移动的像素区间
+    void sliderGeometry(int* sliderMin, int* sliderMax, int* sliderLength, bool* upsideDown) const;
+
     // 将像素位置转换为范围值
     int pixelPosToRangeValue(int pos) const;
 
+    // 将范围值转换为滑块柄中心的像素位置
+    int rangeValueToPixelPos(int value) const;
+
     // 处理鼠标按下事件
     void handleMousePress(const QPoint& pos, QStyle::SubControl& control, int value, QxtSpanSlider::SpanHandle handle);
 
+    // 判断点是否落在两个滑块柄之间的跨度上
+    bool hitSpan(const QPoint& pos) const;
+
+    // 绘制滑块所需的状态，paintEvent() 和离屏渲染共用
+    struct PaintState
+    {
+        int lower;
+        int upper;
+        int lowerPos;
+        int upperPos;
+        QStyle::SubControl lowerPressed;
+        QStyle::SubControl upperPressed;
+        QxtSpanSlider::SpanHandle lastPressed;
+    };
+
     // 绘制滑块柄
-    void drawHandle(QStylePainter* painter, QxtSpanSlider::SpanHandle handle) const;
+    static void drawHandle(QPainter* painter, QStyle* style, const QStyleOptionSlider& option, const PaintState& state,
+                           QxtSpanSlider::SpanHandle handle, const QWidget* widget);
 
     // 设置画笔
-    void setupPainter(QPainter* painter, Qt::Orientation orientation, qreal x1, qreal y1, qreal x2, qreal y2) const;
+    static void setupPainter(QPainter* painter, const QPalette& palette, Qt::Orientation orientation, qreal x1, qreal y1, qreal x2, qreal y2);
+
+    // 计算两个滑块柄之间的跨度矩形，handleRect 返回下限滑块柄的矩形
+    static QRect spanRect(QStyle* style, const QStyleOptionSlider& option, int lowerPos, int upperPos,
+                          const QWidget* widget, QRect* handleRect = 0);
 
     // 绘制跨度
-    void drawSpan(QStylePainter* painter, const QRect& rect) const;
+    static void drawSpan(QPainter* painter, QStyle* style, const QStyleOptionSlider& option, const QRect& rect, const QWidget* widget);
+
+    // 绘制滑槽、跨度和两个滑块，widget 可以为 0
+    static void paintSlider(QPainter* painter, QStyle* style, const QStyleOptionSlider& option, const PaintState& state, const QWidget* widget);
 
     // 触发滑动条动作
     void triggerAction(QAbstractSlider::SliderAction action, bool main);
 
+    // 按移动模式把下限或上限滑块柄移到 value，必要时交换控制
+    void moveHandle(bool upperHandle, int value, int lowerBound, int upperBound);
+
     // 交换控制
     void swapControls();
 
+    // 把范围值换算为 0 到 1 之间的分位数
+    qreal valueToQuantile(int value) const;
+
+    // 采样拖动位置，并在预测跨度离开已预取的窗口时请求预取
+    void trackMotion(qint64 timestamp);
+
+    // 格式化数值并获取缓存的静态文本
+    QString formatValue(int value) const;
+    const QStaticText& staticText(const QString& text) const;
+
+    // 刻度标签布局与绘制
+    int labelStripHeight() const;
+    int labelStripWidth() const;
+    void invalidateLabels();
+    void layoutTickLabels() const;
+    void appendTickLabel(const QString& text, int pos) const;
+    void drawTickLabels(QPainter* painter) const;
+    void drawValueReadouts(QPainter* painter) const;
+
+    // 时间轴刻度的更新与绘制
+    void updateTimeTicks() const;
+    void drawTimeTicks(QPainter* painter, const QStyleOptionSlider& option) const;
+
+    // 叠加层的目标区域与渲染参数，任一项变化时重新渲染
+    struct OverlayKey
+    {
+        QRect rect;
+        int minimum;
+        int maximum;
+        Qt::Orientation orientation;
+        bool upsideDown;
+        bool operator==(const OverlayKey& other) const
+        {
+            return rect == other.rect && minimum == other.minimum && maximum == other.maximum
+                && orientation == other.orientation && upsideDown == other.upsideDown;
+        }
+    };
+
+    // 叠加层渲染与绘制
+    OverlayKey currentOverlayKey() const;
+    void cancelOverlay();
+    void drawOverlay(QPainter* painter);
+
+    // 已布局的刻度标签
+    struct TickLabel
+    {
+        QPointF pos;
+        QString text;
+    };
+
+    // 刻度标签布局的缓存键：尺寸、范围或刻度间隔变化时重新布局
+    struct LabelLayoutKey
+    {
+        QSize size;
+        int minimum;
+        int maximum;
+        int interval;
+        Qt::Orientation orientation;
+        bool upsideDown;
+        bool operator==(const LabelLayoutKey& other) const
+        {
+            return size == other.size && minimum == other.minimum && maximum == other.maximum
+                && interval == other.interval && orientation == other.orientation && upsideDown == other.upsideDown;
+        }
+    };
+
     // 成员变量
     int lower;
     int upper;
@@ -57,9 +167,39 @@ public:
     QxtSpanSlider::SpanHandle mainControl;
     QStyle::SubControl lowerPressed;
     QStyle::SubControl upperPressed;
+    bool spanPressed;
+    int spanPressValue;
+    int spanPressLower;
     QxtSpanSlider::HandleMovementMode movement;
     bool firstMovement;
     bool blockTracking;
+    int updateDepth;
+    bool rangeStaged;
+    bool spanStaged;
+    int stagedLower;
+    int stagedUpper;
+    bool tickLabelsVisible;
+    bool valueReadoutsVisible;
+    QxtSpanSlider::ValueFormatter formatter;
+    mutable QHash<QString, QStaticText> textCache;
+    mutable QVector<TickLabel> tickLabels;
+    mutable LabelLayoutKey labelKey;
+    mutable bool labelsDirty;
+    bool timeAxis;
+    mutable QxtSpanSliderTimeAxis timeTicks;
+    QPointer<QxtSpanSliderOverlay> overlay;
+    QThreadPool* overlayPool;
+    QAtomicInt overlayGeneration;
+    QImage overlayImage;
+    OverlayKey overlayKey;
+    bool overlayScheduled;
+    QxtSpanSliderMotion motion;
+    bool quantileMode;
+    QxtQuantileSketch sketch;
+    int prefetchHorizon;
+    bool prefetchValid;
+    int prefetchLower;
+    int prefetchUpper;
 
 public Q_SLOTS:
     // 更新范围
@@ -68,6 +208,16 @@ public Q_SLOTS:
     // 移动按下的滑块柄
     void movePressedHandle();
 
+    // 分位数模式下发出解析后的数值范围
+    void updateQuantileSpan();
+
+    // 使当前叠加层图像过时并在事件循环中启动新的渲染
+    void scheduleOverlay();
+    void startOverlayRender();
+
+    // 接收工作线程完成的叠加层图像
+    void overlayRendered(const QImage& image, int generation);
+
 private:
     // 指向 QxtSpanSlider 的指针
     QxtSpanSlider* q_ptr;
@@ -0,0 +1,527 @@
+#include "QxtSpanStatistics.h"
+#include "QxtSpanSlider.h"
+#include <cmath>
+#include <limits>
+
+namespace
+{
+const double Infinity = std::numeric_limits<double>::infinity();
+
+// 不大于 n 的最大的 2 的幂的指数
+int floorLog2(int n)
+{
+    int k = 0;
+    while ((2 << k) <= n)
+        ++k;
+    return k;
+}
+} // namespace
+
+/*!
+    \class QxtSpanStatistics
+    \inmodule QxtWidgets
+    \brief QxtSpanStatistics 为 QxtSpanSlider 的跨度实时计算数值的数量、总和、平均值、最小值和最大值。
+
+    数值按 floor(value) 落入 [rangeMinimum(), rangeMaximum()] 中宽度为 bucketWidth() 的桶，超出范围的数值和 NaN 被忽略。
+    桶数不超过 MaximumBuckets，范围过宽时桶宽会被自动加大。每个桶的数量和总和存放在 Fenwick 树中，
+    因此跨度变化时数量和总和的查询为 O(log n)，其中 n 为桶数，与数值的个数无关。
+
+    跨度的端点不在桶的边界上时，两端的桶整体计入；桶宽为 1 时统计是精确的。
+
+    静态模式（默认）下数据只能用 setValues() 整体载入，每个桶的最小值和最大值存放在稀疏表中，查询为 O(1)。
+    流式模式（streaming）下还可以用 addValue() 和 removeValue() 逐个更新：每个桶按数值记录重数，
+    最值存放在线段树中，单点更新和查询都是 O(log n)，移除一个桶的最值后会得到剩余数值中真正的最值。
+    同一轮事件循环中的多次更新只触发一次 statisticsChanged()。
+
+    \code
+    QxtSpanStatistics* stats = new QxtSpanStatistics(this);
+    stats->setRange(slider->minimum(), slider->maximum());
+    stats->setValues(column.constData(), column.size());
+    stats->setSpanSlider(slider);
+    connect(stats, SIGNAL(statisticsChanged(qint64, double, double, double, double)),
+            this, SLOT(showStatistics(qint64, double, double, double, double)));
+    \endcode
+ */
+
+/*!
+    \fn QxtSpanStatistics::statisticsChanged(qint64 count, double sum, double mean, double minimum, double maximum)
+    跨度或数据变化后发出此信号，参数为当前跨度内数值的统计量。跨度变化时，此信号在滑块的 spanChanged() 中同步发出。
+ */
+
+/*!
+    使用 \a parent 构造一个新的 QxtSpanStatistics。初始范围为空。
+ */
+QxtSpanStatistics::QxtSpanStatistics(QObject* parent) :
+        QObject(parent),
+        rangeMin(0),
+        rangeMax(-1),
+        width(1),
+        streaming(false),
+        lower(0),
+        upper(0),
+        tablesDirty(true),
+        refreshScheduled(false),
+        currentCount(0),
+        currentSum(0),
+        currentMin(Infinity),
+        currentMax(-Infinity)
+{
+}
+
+/*!
+    销毁 QxtSpanStatistics 对象。
+ */
+QxtSpanStatistics::~QxtSpanStatistics()
+{
+}
+
+/*!
+    返回绑定的滑块，未绑定时返回 0。
+ */
+QxtSpanSlider* QxtSpanStatistics::spanSlider() const
+{
+    return slider;
+}
+
+/*!
+    绑定 \a slider：跨度跟随滑块的 spanChanged() 变化。传入 0 解除绑定。
+ */
+void QxtSpanStatistics::setSpanSlider(QxtSpanSlider* slider)
+{
+    if (this->slider == slider)
+        return;
+
+    if (this->slider)
+        disconnect(this->slider, SIGNAL(spanChanged(int, int)), this, SLOT(setSpan(int, int)));
+    this->slider = slider;
+    if (slider)
+    {
+        connect(slider, SIGNAL(spanChanged(int, int)), this, SLOT(setSpan(int, int)));
+        setSpan(slider->lowerValue(), slider->upperValue());
+    }
+}
+
+/*!
+    把键的范围设置为 [\a minimum, \a maximum]，每 \a bucketWidth 个整数键为一个桶，并清空已有的数据。
+ */
+void QxtSpanStatistics::setRange(int minimum, int maximum, int bucketWidth)
+{
+    rangeMin = qMin(minimum, maximum);
+    rangeMax = qMax(minimum, maximum);
+    width = qMax(bucketWidth, 1);
+
+    // 桶数超出上限时加大桶宽，使桶数总能用 int 表示
+    const qint64 span = qint64(rangeMax) - rangeMin + 1;
+    if ((span - 1) / width + 1 > MaximumBuckets)
+    {
+        width = int((span + MaximumBuckets - 1) / MaximumBuckets);
+        qWarning("QxtSpanStatistics::setRange: Too many buckets, bucket width raised to %d", width);
+    }
+    clear();
+}
+
+/*!
+    返回键范围的最小值。
+ */
+int QxtSpanStatistics::rangeMinimum() const
+{
+    return rangeMin;
+}
+
+/*!
+    返回键范围的最大值。
+ */
+int QxtSpanStatistics::rangeMaximum() const
+{
+    return rangeMax;
+}
+
+/*!
+    返回桶宽。它可能大于传给 setRange() 的值，见 MaximumBuckets。
+ */
+int QxtSpanStatistics::bucketWidth() const
+{
+    return width;
+}
+
+/*!
+    用 \a values 中的 \a size 个数值替换已有的数据。Fenwick 树以 O(size + n) 的代价一次建成。
+ */
+void QxtSpanStatistics::setValues(const double* values, qint64 size)
+{
+    const int buckets = bucketMin.size();
+    QVector<qint64> counts(buckets + 1, 0);
+    QVector<double> sums(buckets + 1, 0);
+    bucketMin.fill(Infinity);
+    bucketMax.fill(-Infinity);
+    if (streaming)
+        bucketValues = QVector<QMap<double, qint64> >(buckets);
+    for (qint64 i = 0; i < size; ++i)
+    {
+        const int b = bucketOf(values[i]);
+        if (b < 0)
+            continue;
+        ++counts[b + 1];
+        sums[b + 1] += values[i];
+        bucketMin[b] = qMin(bucketMin.at(b), values[i]);
+        bucketMax[b] = qMax(bucketMax.at(b), values[i]);
+        if (streaming)
+            ++bucketValues[b][values[i]];
+    }
+
+    // 流式模式下自底向上建立线段树
+    if (streaming)
+    {
+        for (int i = 0; i < buckets; ++i)
+        {
+            minSegment[buckets + i] = bucketMin.at(i);
+            maxSegment[buckets + i] = bucketMax.at(i);
+        }
+        for (int i = buckets - 1; i > 0; --i)
+        {
+            minSegment[i] = qMin(minSegment.at(2 * i), minSegment.at(2 * i + 1));
+            maxSegment[i] = qMax(maxSegment.at(2 * i), maxSegment.at(2 * i + 1));
+        }
+    }
+
+    // 线性时间建树：每个节点把自己的值累加到父节点
+    for (int i = 1; i <= buckets; ++i)
+    {
+        const int parent = i + (i & -i);
+        if (parent <= buckets)
+        {
+            counts[parent] += counts.at(i);
+            sums[parent] += sums.at(i);
+        }
+    }
+    countTree = counts;
+    sumTree = sums;
+    tablesDirty = true;
+    refresh();
+}
+
+/*!
+    \property QxtSpanStatistics::streaming
+    \brief 是否允许用 addValue() 和 removeValue() 逐个更新
+
+    流式模式按数值记录每个桶中的重数，并用线段树维护最值，内存与数值的个数成正比；
+    静态模式只保存每个桶的汇总，最值用稀疏表查询。切换模式会清空已有的数据。默认值为 false。
+ */
+bool QxtSpanStatistics::isStreaming() const
+{
+    return streaming;
+}
+
+void QxtSpanStatistics::setStreaming(bool enabled)
+{
+    if (streaming != enabled)
+    {
+        streaming = enabled;
+        clear();
+    }
+}
+
+/*!
+    加入数值 \a value。超出范围的数值和 NaN 被忽略。只在流式模式下可用。
+ */
+void QxtSpanStatistics::addValue(double value)
+{
+    if (!streaming)
+    {
+        qWarning("QxtSpanStatistics::addValue: Point updates require streaming mode");
+        return;
+    }
+    const int b = bucketOf(value);
+    if (b < 0)
+        return;
+
+    fenwickAdd(b, 1, value);
+    ++bucketValues[b][value];
+    if (value < bucketMin.at(b) || value > bucketMax.at(b))
+    {
+        bucketMin[b] = qMin(bucketMin.at(b), value);
+        bucketMax[b] = qMax(bucketMax.at(b), value);
+        segmentUpdate(b);
+    }
+    scheduleRefresh();
+}
+
+/*!
+    移除一个之前加入的数值 \a value。数据中没有该数值时不做任何事。只在流式模式下可用。
+ */
+void QxtSpanStatistics::removeValue(double value)
+{
+    if (!streaming)
+    {
+        qWarning("QxtSpanStatistics::removeValue: Point updates require streaming mode");
+        return;
+    }
+    const int b = bucketOf(value);
+    if (b < 0)
+        return;
+
+    QMap<double, qint64>& values = bucketValues[b];
+    const QMap<double, qint64>::iterator it = values.find(value);
+    if (it == values.end())
+        return;
+    if (--it.value() == 0)
+        values.erase(it);
+    fenwickAdd(b, -1, -value);
+
+    // 由剩余数值的重数得到桶中真正的最值
+    const double newMin = values.isEmpty() ? Infinity : values.firstKey();
+    const double newMax = values.isEmpty() ? -Infinity : values.lastKey();
+    if (newMin != bucketMin.at(b) || newMax != bucketMax.at(b))
+    {
+        bucketMin[b] = newMin;
+        bucketMax[b] = newMax;
+        segmentUpdate(b);
+    }
+    scheduleRefresh();
+}
+
+/*!
+    清空所有数据，保留键的范围和桶宽。
+ */
+void QxtSpanStatistics::clear()
+{
+    const int buckets = (rangeMax < rangeMin) ? 0 : int((qint64(rangeMax) - rangeMin) / width + 1);
+    bucketMin = QVector<double>(buckets, Infinity);
+    bucketMax = QVector<double>(buckets, -Infinity);
+    countTree = QVector<qint64>(buckets + 1, 0);
+    sumTree = QVector<double>(buckets + 1, 0);
+    if (streaming)
+    {
+        minSegment = QVector<double>(2 * buckets, Infinity);
+        maxSegment = QVector<double>(2 * buckets, -Infinity);
+        bucketValues = QVector<QMap<double, qint64> >(buckets);
+    }
+    else
+    {
+        minSegment.clear();
+        maxSegment.clear();
+        bucketValues.clear();
+    }
+    tablesDirty = true;
+    refresh();
+}
+
+/*!
+    \property QxtSpanStatistics::lowerValue
+    \brief 统计跨度的下限
+ */
+int QxtSpanStatistics::lowerValue() const
+{
+    return lower;
+}
+
+/*!
+    \property QxtSpanStatistics::upperValue
+    \brief 统计跨度的上限
+ */
+int QxtSpanStatistics::upperValue() const
+{
+    return upper;
+}
+
+/*!
+    \property QxtSpanStatistics::count
+    \brief 当前跨度内数值的个数
+ */
+qint64 QxtSpanStatistics::count() const
+{
+    return currentCount;
+}
+
+/*!
+    \property QxtSpanStatistics::sum
+    \brief 当前跨度内数值的总和
+ */
+double QxtSpanStatistics::sum() const
+{
+    return currentSum;
+}
+
+/*!
+    \property QxtSpanStatistics::mean
+    \brief 当前跨度内数值的平均值，没有数值时为 NaN
+ */
+double QxtSpanStatistics::mean() const
+{
+    return currentCount > 0 ? currentSum / currentCount : std::numeric_limits<double>::quiet_NaN();
+}
+
+/*!
+    \property QxtSpanStatistics::minimum
+    \brief 当前跨度内数值的最小值，没有数值时为 NaN
+ */
+double QxtSpanStatistics::minimum() const
+{
+    return currentCount > 0 ? currentMin : std::numeric_limits<double>::quiet_NaN();
+}
+
+/*!
+    \property QxtSpanStatistics::maximum
+    \brief 当前跨度内数值的最大值，没有数值时为 NaN
+ */
+double QxtSpanStatistics::maximum() const
+{
+    return currentCount > 0 ? currentMax : std::numeric_limits<double>::quiet_NaN();
+}
+
+/*!
+    把统计的跨度设置为 [\a lower, \a upper]，立即重新计算并发出 statisticsChanged()。
+ */
+void QxtSpanStatistics::setSpan(int lower, int upper)
+{
+    this->lower = qMin(lower, upper);
+    this->upper = qMax(lower, upper);
+    refresh();
+}
+
+int QxtSpanStatistics::bucketOf(double value) const
+{
+    if (qIsNaN(value))
+        return -1;
+    const double key = std::floor(value);
+    if (key < rangeMin || key > rangeMax)
+        return -1;
+    return int((qint64(key) - rangeMin) / width);
+}
+
+void QxtSpanStatistics::fenwickAdd(int bucket, qint64 count, double sum)
+{
+    for (int i = bucket + 1; i < countTree.size(); i += (i & -i))
+    {
+        countTree[i] += count;
+        sumTree[i] += sum;
+    }
+}
+
+qint64 QxtSpanStatistics::prefixCount(int bucket) const
+{
+    qint64 result = 0;
+    for (int i = bucket + 1; i > 0; i -= (i & -i))
+        result += countTree.at(i);
+    return result;
+}
+
+double QxtSpanStatistics::prefixSum(int bucket) const
+{
+    double result = 0;
+    for (int i = bucket + 1; i > 0; i -= (i & -i))
+        result += sumTree.at(i);
+    return result;
+}
+
+void QxtSpanStatistics::ensureSparseTables() const
+{
+    if (!tablesDirty)
+        return;
+
+    const int buckets = bucketMin.size();
+    const int levels = buckets > 0 ? floorLog2(buckets) + 1 : 0;
+    minTable.resize(levels);
+    maxTable.resize(levels);
+    if (levels > 0)
+    {
+        minTable[0] = bucketMin;
+        maxTable[0] = bucketMax;
+    }
+    for (int j = 1; j < levels; ++j)
+    {
+        const int half = 1 << (j - 1);
+        const int size = buckets - (1 << j) + 1;
+        const QVector<double>& minBelow = minTable.at(j - 1);
+        const QVector<double>& maxBelow = maxTable.at(j - 1);
+        QVector<double>& minLevel = minTable[j];
+        QVector<double>& maxLevel = maxTable[j];
+        minLevel.resize(size);
+        maxLevel.resize(size);
+        for (int i = 0; i < size; ++i)
+        {
+            minLevel[i] = qMin(minBelow.at(i), minBelow.at(i + half));
+            maxLevel[i] = qMax(maxBelow.at(i), maxBelow.at(i + half));
+        }
+    }
+    tablesDirty = false;
+}
+
+void QxtSpanStatistics::segmentUpdate(int bucket)
+{
+    const int buckets = bucketMin.size();
+    int i = buckets + bucket;
+    minSegment[i] = bucketMin.at(bucket);
+    maxSegment[i] = bucketMax.at(bucket);
+    for (i /= 2; i > 0; i /= 2)
+    {
+        minSegment[i] = qMin(minSegment.at(2 * i), minSegment.at(2 * i + 1));
+        maxSegment[i] = qMax(maxSegment.at(2 * i), maxSegment.at(2 * i + 1));
+    }
+}
+
+void QxtSpanStatistics::rangeExtremes(int first, int last, double* min, double* max) const
+{
+    if (!streaming)
+    {
+        // 静态数据：稀疏表的两个重叠区间覆盖 [first, last]
+        ensureSparseTables();
+        const int k = floorLog2(last - first + 1);
+        const int second = last - (1 << k) + 1;
+        *min = qMin(minTable.at(k).at(first), minTable.at(k).at(second));
+        *max = qMax(maxTable.at(k).at(first), maxTable.at(k).at(second));
+        return;
+    }
+
+    // 流式数据：自底向上的线段树查询，区间为 [l, r)
+    *min = Infinity;
+    *max = -Infinity;
+    const int buckets = bucketMin.size();
+    for (int l = first + buckets, r = last + 1 + buckets; l < r; l /= 2, r /= 2)
+    {
+        if (l & 1)
+        {
+            *min = qMin(*min, minSegment.at(l));
+            *max = qMax(*max, maxSegment.at(l));
+            ++l;
+        }
+        if (r & 1)
+        {
+            --r;
+            *min = qMin(*min, minSegment.at(r));
+            *max = qMax(*max, maxSegment.at(r));
+        }
+    }
+}
+
+void QxtSpanStatistics::scheduleRefresh()
+{
+    if (!refreshScheduled)
+    {
+        refreshScheduled = true;
+        QMetaObject::invokeMethod(this, "refresh", Qt::QueuedConnection);
+    }
+}
+
+void QxtSpanStatistics::refresh()
+{
+    refreshScheduled = false;
+    currentCount = 0;
+    currentSum = 0;
+    currentMin = Infinity;
+    currentMax = -Infinity;
+
+    // 把跨度限制在键的范围内并换算为桶的区间
+    const int low = qMax(lower, rangeMin);
+    const int high = qMin(upper, rangeMax);
+    if (low <= high && !bucketMin.isEmpty())
+    {
+        const int first = int((qint64(low) - rangeMin) / width);
+        const int last = int((qint64(high) - rangeMin) / width);
+        currentCount = prefixCount(last) - prefixCount(first - 1);
+        currentSum = prefixSum(last) - prefixSum(first - 1);
+        rangeExtremes(first, last, &currentMin, &currentMax);
+    }
+
+    emit statisticsChanged(currentCount, currentSum, mean(), minimum(), maximum());
+}
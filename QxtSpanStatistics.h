@@ -0,0 +1,133 @@
+#ifndef QXTSPANSTATISTICS_H
+#define QXTSPANSTATISTICS_H
+
+#include <QObject>
+#include <QMap>
+#include <QPointer>
+#include <QVector>
+
+// 前向声明
+class QxtSpanSlider;
+
+// QxtSpanStatistics 把数值按整数键分桶，用 Fenwick 树维护数量和总和、用稀疏表维护最小值和最大值，
+// 在绑定滑块的跨度变化时以 O(log n) 的代价给出 [lowerValue(), upperValue()] 内数值的统计量
+class QxtSpanStatistics : public QObject {
+    Q_OBJECT
+
+    // 属性声明，用于集成 Qt 的属性系统
+    Q_PROPERTY(int lowerValue READ lowerValue)
+    Q_PROPERTY(int upperValue READ upperValue)
+    Q_PROPERTY(qint64 count READ count)
+    Q_PROPERTY(double sum READ sum)
+    Q_PROPERTY(double mean READ mean)
+    Q_PROPERTY(double minimum READ minimum)
+    Q_PROPERTY(double maximum READ maximum)
+    Q_PROPERTY(bool streaming READ isStreaming WRITE setStreaming)
+
+public:
+    // 构造函数
+    explicit QxtSpanStatistics(QObject* parent = 0);
+    virtual ~QxtSpanStatistics(); // 析构函数
+
+    // 获取和设置绑定的滑块
+    QxtSpanSlider* spanSlider() const;
+    void setSpanSlider(QxtSpanSlider* slider);
+
+    // 桶数的上限，超出时自动加大桶宽
+    enum { MaximumBuckets = 1 << 16 };
+
+    // 设置键的范围和桶宽，清空已有的数据
+    void setRange(int minimum, int maximum, int bucketWidth = 1);
+    int rangeMinimum() const;
+    int rangeMaximum() const;
+    int bucketWidth() const;
+
+    // 批量载入数值，替换已有的数据
+    void setValues(const double* values, qint64 size);
+
+    // 流式模式：允许逐个加入或移除数值，切换时清空已有的数据
+    bool isStreaming() const;
+    void setStreaming(bool enabled);
+
+    // 流式模式下逐个加入或移除数值
+    void addValue(double value);
+    void removeValue(double value);
+    void clear();
+
+    // 获取当前跨度
+    int lowerValue() const;
+    int upperValue() const;
+
+    // 获取当前跨度内数值的统计量，没有数值时平均值、最小值和最大值为 NaN
+    qint64 count() const;
+    double sum() const;
+    double mean() const;
+    double minimum() const;
+    double maximum() const;
+
+public Q_SLOTS:
+    // 设置统计的跨度，从 lower 到 upper
+    void setSpan(int lower, int upper);
+
+Q_SIGNALS:
+    // 跨度或数据变化后发出当前跨度的统计量
+    void statisticsChanged(qint64 count, double sum, double mean, double minimum, double maximum);
+
+private Q_SLOTS:
+    // 重新计算当前跨度的统计量并发出信号
+    void refresh();
+
+private:
+    // 数值所在的桶，超出范围或为 NaN 时返回 -1
+    int bucketOf(double value) const;
+
+    // Fenwick 树的单点更新和前缀查询
+    void fenwickAdd(int bucket, qint64 count, double sum);
+    qint64 prefixCount(int bucket) const;
+    double prefixSum(int bucket) const;
+
+    // 按需重建最小值和最大值的稀疏表（静态模式）
+    void ensureSparseTables() const;
+
+    // 更新线段树中一个桶的最小值和最大值（流式模式）
+    void segmentUpdate(int bucket);
+
+    // 查询桶区间 [first, last] 内的最小值和最大值
+    void rangeExtremes(int first, int last, double* min, double* max) const;
+
+    // 数据变化后在事件循环中合并为一次 refresh()
+    void scheduleRefresh();
+
+    QPointer<QxtSpanSlider> slider;
+    int rangeMin;
+    int rangeMax;
+    int width;
+    bool streaming;
+    int lower;
+    int upper;
+
+    // 每个桶的最小值和最大值，以及 Fenwick 树（下标从 1 开始）
+    QVector<double> bucketMin;
+    QVector<double> bucketMax;
+    QVector<qint64> countTree;
+    QVector<double> sumTree;
+
+    // 静态模式的稀疏表：第 j 层的第 i 项为 [i, i + 2^j) 内的最值
+    mutable QVector<QVector<double> > minTable;
+    mutable QVector<QVector<double> > maxTable;
+    mutable bool tablesDirty;
+
+    // 流式模式的线段树（叶子从下标 n 开始）以及每个桶内各数值的重数
+    QVector<double> minSegment;
+    QVector<double> maxSegment;
+    QVector<QMap<double, qint64> > bucketValues;
+    bool refreshScheduled;
+
+    // 当前跨度的统计量
+    qint64 currentCount;
+    double currentSum;
+    double currentMin;
+    double currentMax;
+};
+
+#endif // QXTSPANSTATISTICS_H
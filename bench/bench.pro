@@ -0,0 +1,9 @@
+# Benchmarks for QxtSpanSlider. Build with: qmake bench/bench.pro && make
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    render \
+    filter
+
+qtHaveModule(network): SUBDIRS += sync
@@ -0,0 +1,9 @@
+# Throughput of QxtSpanFilter per kernel and thread count.
+
+TARGET = bench_filter
+TEMPLATE = app
+
+include(../spanslider.pri)
+
+SOURCES += \
+    main.cpp
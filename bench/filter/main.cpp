@@ -0,0 +1,102 @@
+#include "QxtSpanFilter.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTextStream>
+#include <QThread>
+#include <QVector>
+#include <limits>
+
+// 用法：bench_filter [元素数量] [重复次数]
+// 对 float 列分别用标量、SSE2 和 AVX2 内核以及 1、2、4……直到 idealThreadCount() 个线程执行 count()，
+// 输出每种组合的最短耗时、吞吐量和相对单线程标量内核的加速比。处理器不支持的内核被跳过。
+namespace
+{
+qint64 argument(const QStringList& args, int index, qint64 fallback)
+{
+    bool ok = false;
+    const qint64 value = index < args.size() ? args.at(index).toLongLong(&ok) : 0;
+    return (ok && value > 0) ? value : fallback;
+}
+
+const char* kernelName(QxtSpanFilter::Kernel kernel)
+{
+    switch (kernel)
+    {
+    case QxtSpanFilter::Avx2Kernel:
+        return "avx2";
+    case QxtSpanFilter::Sse2Kernel:
+        return "sse2";
+    default:
+        return "scalar";
+    }
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    const QStringList args = a.arguments();
+    const qint64 size = argument(args, 1, 100000000);
+    const int repeats = int(argument(args, 2, 5));
+
+    // 线性同余生成 [0, 1000) 内的数值，跨度 [250, 749] 选中约一半，分支无法预测
+    QTextStream out(stdout);
+    out << "generating " << size << " floats" << endl;
+    QVector<float> column(int(qMin<qint64>(size, std::numeric_limits<int>::max())));
+    quint32 state = 12345;
+    for (int i = 0; i < column.size(); ++i)
+    {
+        state = state * 1664525u + 1013904223u;
+        column[i] = (state >> 8) * (1000.0f / (1 << 24));
+    }
+
+    const QxtSpanFilter::Kernel kernels[] = {
+        QxtSpanFilter::ScalarKernel, QxtSpanFilter::Sse2Kernel, QxtSpanFilter::Avx2Kernel
+    };
+    const int ideal = qMax(1, QThread::idealThreadCount());
+    double baseline = 0;
+    qint64 expected = -1;
+    for (int k = 0; k < 3; ++k)
+    {
+        QxtSpanFilter::setKernel(kernels[k]);
+        if (QxtSpanFilter::kernel() != kernels[k])
+        {
+            out << kernelName(kernels[k]) << ": not supported on this processor" << endl;
+            continue;
+        }
+
+        for (int threads = 1; ; threads = qMin(threads * 2, ideal))
+        {
+            QxtSpanFilter filter(250, 749);
+            filter.setThreadCount(threads);
+            qint64 best = std::numeric_limits<qint64>::max();
+            qint64 selected = 0;
+            for (int r = 0; r < repeats; ++r)
+            {
+                QElapsedTimer timer;
+                timer.start();
+                selected = filter.count(column.constData(), column.size());
+                best = qMin(best, timer.nsecsElapsed());
+            }
+
+            // 所有内核和线程数必须得到相同的结果
+            if (expected < 0)
+                expected = selected;
+            else if (selected != expected)
+                out << "MISMATCH: " << selected << " != " << expected << endl;
+
+            const double ms = best / 1e6;
+            if (baseline == 0)
+                baseline = ms;
+            out << kernelName(kernels[k]) << " x" << threads << ": "
+                << QString::number(ms, 'f', 1) << " ms  "
+                << QString::number(column.size() / (ms * 1e6), 'f', 2) << " Gelem/s  "
+                << QString::number(baseline / ms, 'f', 2) << "x" << endl;
+            if (threads == ideal)
+                break;
+        }
+    }
+    QxtSpanFilter::setKernel(QxtSpanFilter::Avx2Kernel);
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include "QxtSpanSlider.h"
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QStyle>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+
+// 用法：bench_render [图像数量] [宽度] [高度]
+// 先逐个调用 renderImage()，再用 1、2、4……直到 idealThreadCount() 个线程的线程池调用 renderImages()，
+// 输出每种方式每秒渲染的图像数。
+namespace
+{
+int argument(const QStringList& args, int index, int fallback)
+{
+    bool ok = false;
+    const int value = index < args.size() ? args.at(index).toInt(&ok) : 0;
+    return (ok && value > 0) ? value : fallback;
+}
+
+void report(QTextStream& out, const QString& name, int images, qint64 nsecs)
+{
+    const double seconds = nsecs / 1e9;
+    out << qSetFieldWidth(24) << left << name << qSetFieldWidth(0)
+        << QString::number(seconds * 1000, 'f', 1) << " ms  "
+        << QString::number(images / seconds, 'f', 0) << " images/s" << endl;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QApplication a(argc, argv);
+    const QStringList args = a.arguments();
+    const int count = argument(args, 1, 2000);
+    const QSize size(argument(args, 2, 160), argument(args, 3, 22));
+
+    // 跨度在范围内滑动，每幅图像的状态都不同
+    QVector<QxtSpanSliderRenderOptions> options(count);
+    for (int i = 0; i < count; ++i)
+    {
+        QxtSpanSliderRenderOptions& opt = options[i];
+        opt.size = size;
+        opt.minimum = 0;
+        opt.maximum = 999;
+        opt.lower = (i * 7) % 800;
+        opt.upper = opt.lower + 100 + (i % 100);
+        opt.tickPosition = QSlider::TicksBelow;
+        opt.tickInterval = 100;
+        opt.palette = a.palette();
+    }
+
+    QTextStream out(stdout);
+    out << count << " images of " << size.width() << "x" << size.height()
+        << ", style " << a.style()->objectName() << endl;
+
+    // 预热：样式缓存和字体在第一次绘制时加载
+    QxtSpanSlider::renderImage(options.first());
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < count; ++i)
+        QxtSpanSlider::renderImage(options.at(i));
+    report(out, QLatin1String("renderImage()"), count, timer.nsecsElapsed());
+
+    const int ideal = qMax(1, QThread::idealThreadCount());
+    for (int threads = 1; ; threads = qMin(threads * 2, ideal))
+    {
+        QThreadPool pool;
+        pool.setMaxThreadCount(threads);
+        QxtSpanSlider::renderImages(options.mid(0, threads * 16), &pool);
+
+        timer.restart();
+        const QVector<QImage> images = QxtSpanSlider::renderImages(options, &pool);
+        report(out, QString::fromLatin1("renderImages() x%1").arg(threads), images.size(), timer.nsecsElapsed());
+        if (threads == ideal)
+            break;
+    }
+    return 0;
+}
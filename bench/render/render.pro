@@ -0,0 +1,9 @@
+# Images/sec of QxtSpanSlider::renderImage() and renderImages() across thread pool sizes.
+
+TARGET = bench_render
+TEMPLATE = app
+
+include(../spanslider.pri)
+
+SOURCES += \
+    main.cpp
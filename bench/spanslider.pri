@@ -0,0 +1,46 @@
+# QxtSpanSlider sources shared by the benchmark subprojects.
+
+QT       += core gui
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+SPANSLIDER_DIR = $$PWD/..
+INCLUDEPATH += $$SPANSLIDER_DIR
+DEPENDPATH += $$SPANSLIDER_DIR
+
+SOURCES += \
+    $$SPANSLIDER_DIR/QxtSpanSlider.cpp \
+    $$SPANSLIDER_DIR/QxtSpanSliderNavigator.cpp \
+    $$SPANSLIDER_DIR/QxtSpanSliderOverlay.cpp \
+    $$SPANSLIDER_DIR/QxtSpanFilter.cpp \
+    $$SPANSLIDER_DIR/QxtSpanFilterProxyModel.cpp \
+    $$SPANSLIDER_DIR/QxtSpanSliderTrace.cpp \
+    $$SPANSLIDER_DIR/QxtSpanSliderTimeAxis.cpp \
+    $$SPANSLIDER_DIR/QxtSpanSliderMotion.cpp \
+    $$SPANSLIDER_DIR/QxtSpanDataSource.cpp \
+    $$SPANSLIDER_DIR/QxtSpanDataOverlay.cpp \
+    $$SPANSLIDER_DIR/QxtQuantileSketch.cpp \
+    $$SPANSLIDER_DIR/QxtSpanStatistics.cpp \
+    $$SPANSLIDER_DIR/QxtSpanSliderLogic.cpp
+
+HEADERS += \
+    $$SPANSLIDER_DIR/QxtSpanSlider.h \
+    $$SPANSLIDER_DIR/QxtSpanSlider_p.h \
+    $$SPANSLIDER_DIR/QxtSpanSliderNavigator.h \
+    $$SPANSLIDER_DIR/QxtSpanSliderOverlay.h \
+    $$SPANSLIDER_DIR/QxtSpanSliderOverlay_p.h \
+    $$SPANSLIDER_DIR/QxtSpanFilter.h \
+    $$SPANSLIDER_DIR/QxtSpanFilterProxyModel.h \
+    $$SPANSLIDER_DIR/QxtSpanSliderTrace.h \
+    $$SPANSLIDER_DIR/QxtSpanSliderTimeAxis_p.h \
+    $$SPANSLIDER_DIR/QxtSpanSliderMotion_p.h \
+    $$SPANSLIDER_DIR/QxtSpanDataSource.h \
+    $$SPANSLIDER_DIR/QxtSpanDataOverlay.h \
+    $$SPANSLIDER_DIR/QxtQuantileSketch.h \
+    $$SPANSLIDER_DIR/QxtSpanStatistics.h \
+    $$SPANSLIDER_DIR/QxtSpanSliderLogic_p.h
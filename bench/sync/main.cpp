@@ -0,0 +1,197 @@
+#include "QxtSpanSlider.h"
+#include "QxtSpanSliderSync.h"
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QProcess>
+#include <QStringList>
+#include <QTextStream>
+#include <QTimer>
+#include <QVector>
+#include <algorithm>
+
+// 用法：bench_sync [客户端数量] [往返次数]
+// 中转进程启动 N 个客户端进程并等待它们全部连接，然后逐次发布宽度为 10 的跨度 [i, i + 10]。
+// 第 i % N 个客户端应用后立即发布 [i, i + 11] 作为应答，中转应用应答时记录一次往返的耗时。
+// 其余客户端也会收到每一帧，因此耗时包含向 N 个进程扇出的开销。
+namespace
+{
+int argument(const QStringList& args, int index, int fallback)
+{
+    bool ok = false;
+    const int value = index < args.size() ? args.at(index).toInt(&ok) : 0;
+    return (ok && value > 0) ? value : fallback;
+}
+} // namespace
+
+// 客户端：应答轮到自己的跨度
+class Client : public QObject {
+    Q_OBJECT
+public:
+    Client(const QString& name, int index, int count, int iterations) :
+            index(index),
+            count(count),
+            slider(Qt::Horizontal)
+    {
+        slider.setRange(0, iterations + 11);
+        sync = new QxtSpanSliderSync(&slider, this);
+        connect(sync, SIGNAL(remoteSpanApplied(int, int, quint64)), this, SLOT(answer(int, int)));
+        connect(sync, SIGNAL(peerDisconnected()), qApp, SLOT(quit()));
+        sync->connectToServer(name);
+
+        // 连接失败的对端会被移除，此时退出而不是一直等待
+        QTimer* check = new QTimer(this);
+        connect(check, SIGNAL(timeout()), this, SLOT(checkActive()));
+        check->start(1000);
+    }
+
+private Q_SLOTS:
+    void answer(int lower, int upper)
+    {
+        if (upper - lower == 10 && lower % count == index)
+            slider.setSpan(lower, lower + 11);
+    }
+
+    void checkActive()
+    {
+        if (!sync->isActive())
+            qApp->exit(1);
+    }
+
+private:
+    int index;
+    int count;
+    QxtSpanSlider slider;
+    QxtSpanSliderSync* sync;
+};
+
+// 中转：发布跨度并记录应答的往返耗时
+class Hub : public QObject {
+    Q_OBJECT
+public:
+    Hub(const QString& name, int clients, int iterations) :
+            clients(clients),
+            iterations(iterations),
+            connected(0),
+            sent(0),
+            slider(Qt::Horizontal)
+    {
+        // 与客户端的滑块使用相同的范围
+        slider.setRange(0, iterations + 11);
+        sync = new QxtSpanSliderSync(&slider, this);
+        connect(sync, SIGNAL(peerConnected()), this, SLOT(peerConnected()));
+        connect(sync, SIGNAL(remoteSpanApplied(int, int, quint64)), this, SLOT(answered(int, int)));
+        if (!sync->listen(name))
+        {
+            QTextStream(stderr) << "cannot listen on " << name << endl;
+            QTimer::singleShot(0, qApp, SLOT(quit()));
+            return;
+        }
+
+        for (int i = 0; i < clients; ++i)
+        {
+            QProcess* process = new QProcess(this);
+            process->setProcessChannelMode(QProcess::ForwardedChannels);
+            process->start(QCoreApplication::applicationFilePath(),
+                           QStringList() << QLatin1String("--client") << name << QString::number(i)
+                                         << QString::number(clients) << QString::number(iterations));
+            processes.append(process);
+        }
+
+        QTimer::singleShot(60000, this, SLOT(timeout()));
+    }
+
+private Q_SLOTS:
+    void peerConnected()
+    {
+        if (++connected == clients)
+            ping();
+    }
+
+    void ping()
+    {
+        if (sent == iterations)
+        {
+            finish();
+            return;
+        }
+        timer.start();
+        slider.setSpan(sent, sent + 10);
+    }
+
+    void answered(int lower, int upper)
+    {
+        if (upper - lower != 11 || lower != sent)
+            return;
+        samples.append(timer.nsecsElapsed());
+        ++sent;
+        QMetaObject::invokeMethod(this, "ping", Qt::QueuedConnection);
+    }
+
+    void timeout()
+    {
+        QTextStream(stderr) << "timed out after " << sent << " round trips with " << connected
+                            << " of " << clients << " clients connected" << endl;
+        shutdown();
+        qApp->exit(1);
+    }
+
+private:
+    double percentile(double p) const
+    {
+        const int i = qBound(0, int(p * (samples.size() - 1) + 0.5), samples.size() - 1);
+        return samples.at(i) / 1000.0;
+    }
+
+    void finish()
+    {
+        std::sort(samples.begin(), samples.end());
+        QTextStream out(stdout);
+        out << clients << " clients, " << samples.size() << " round trips (us): "
+            << "min " << QString::number(percentile(0), 'f', 1)
+            << "  p50 " << QString::number(percentile(0.5), 'f', 1)
+            << "  p90 " << QString::number(percentile(0.9), 'f', 1)
+            << "  p99 " << QString::number(percentile(0.99), 'f', 1)
+            << "  max " << QString::number(percentile(1), 'f', 1) << endl;
+        shutdown();
+        qApp->quit();
+    }
+
+    // 关闭中转后客户端收到 peerDisconnected() 并退出
+    void shutdown()
+    {
+        sync->close();
+        for (int i = 0; i < processes.size(); ++i)
+        {
+            if (!processes.at(i)->waitForFinished(5000))
+                processes.at(i)->kill();
+        }
+    }
+
+    int clients;
+    int iterations;
+    int connected;
+    int sent;
+    QxtSpanSlider slider;
+    QxtSpanSliderSync* sync;
+    QList<QProcess*> processes;
+    QElapsedTimer timer;
+    QVector<qint64> samples;
+};
+
+int main(int argc, char *argv[])
+{
+    QApplication a(argc, argv);
+    const QStringList args = a.arguments();
+
+    if (args.value(1) == QLatin1String("--client"))
+    {
+        Client client(args.value(2), args.value(3).toInt(), argument(args, 4, 1), argument(args, 5, 2000));
+        return a.exec();
+    }
+
+    const QString name = QString::fromLatin1("qxt-bench-sync-%1").arg(QCoreApplication::applicationPid());
+    Hub hub(name, argument(args, 1, 4), argument(args, 2, 2000));
+    return a.exec();
+}
+
+#include "main.moc"
@@ -0,0 +1,15 @@
+# Publish -> apply round-trip latency of QxtSpanSliderSync with a hub and N client processes.
+
+TARGET = bench_sync
+TEMPLATE = app
+
+include(../spanslider.pri)
+
+QT += network
+
+SOURCES += \
+    main.cpp \
+    $$SPANSLIDER_DIR/QxtSpanSliderSync.cpp
+
+HEADERS += \
+    $$SPANSLIDER_DIR/QxtSpanSliderSync.h
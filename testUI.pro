@@ -22,16 +22,58 @@ DEFINES += QT_DEPRECATED_WARNINGS
 # You can also select to disable deprecated APIs only up to a certain version of Qt.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+# Compile the QxtSpanSlider trace points (see QxtSpanSliderTrace).
+#DEFINES += QXT_SPANSLIDER_TRACE
+
 
 SOURCES += \
         main.cpp \
         mainwindow.cpp \
-    QxtSpanSlider.cpp
+    QxtSpanSlider.cpp \
+    QxtSpanSliderNavigator.cpp \
+    QxtSpanSliderOverlay.cpp \
+    QxtSpanFilter.cpp \
+    QxtSpanFilterProxyModel.cpp \
+    QxtSpanSliderTrace.cpp \
+    QxtSpanSliderTimeAxis.cpp \
+    QxtSpanSliderMotion.cpp \
+    QxtSpanDataSource.cpp \
+    QxtSpanDataOverlay.cpp \
+    QxtQuantileSketch.cpp \
+    QxtSpanStatistics.cpp \
+    QxtSpanSliderLogic.cpp
 
 HEADERS += \
         mainwindow.h \
     QxtSpanSlider.h \
-    QxtSpanSlider_p.h
+    QxtSpanSlider_p.h \
+    QxtSpanSliderNavigator.h \
+    QxtSpanSliderOverlay.h \
+    QxtSpanSliderOverlay_p.h \
+    QxtSpanFilter.h \
+    QxtSpanFilterProxyModel.h \
+    QxtSpanSliderTrace.h \
+    QxtSpanSliderTimeAxis_p.h \
+    QxtSpanSliderMotion_p.h \
+    QxtSpanDataSource.h \
+    QxtSpanDataOverlay.h \
+    QxtQuantileSketch.h \
+    QxtSpanStatistics.h \
+    QxtSpanSliderLogic_p.h
+
+# Cross-process span synchronisation needs QtNetwork (QLocalSocket).
+qtHaveModule(network) {
+    QT += network
+    SOURCES += QxtSpanSliderSync.cpp
+    HEADERS += QxtSpanSliderSync.h
+}
+
+# Retained-mode Qt Quick version of the span slider.
+qtHaveModule(quick) {
+    QT += quick
+    SOURCES += QxtQuickSpanSlider.cpp
+    HEADERS += QxtQuickSpanSlider.h
+}
 
 FORMS += \
         mainwindow.ui